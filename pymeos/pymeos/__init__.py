@@ -1,7 +1,13 @@
 from .aggregators import *
 from .boxes import *
+from .cache import ResultCache, CacheStatistics, enable_result_cache, disable_result_cache, get_result_cache
+from .lazy import LazyTemporal, LazyCollection
 from .main import *
 from .meos_init import *
+from .number import *
+from .processing import *
+from .shared import SharedTemporalCollection
+from .table import MovingObjectTable, TableQuery
 from .temporal import *
 from .time import *
 
@@ -21,6 +27,8 @@ __all__ = [
     'TGeogPoint', 'TGeogPointInst', 'TGeogPointSeq', 'TGeogPointSeqSet',
     # temporal
     'Temporal', 'TInstant', 'TSequence', 'TSequenceSet',
+    # number
+    'Span', 'IntSpan', 'FloatSpan', 'SpanSet', 'IntSpanSet', 'FloatSpanSet',
     # time
     'Time', 'Period', 'TimestampSet', 'PeriodSet',
     # extras
@@ -35,4 +43,32 @@ __all__ = [
     'TemporalTextMaxAggregator', 'TemporalTextMinAggregator',
     'TemporalPointExtentAggregator',
     'TemporalTimestampUnionAggregator', 'TemporalPeriodUnionAggregator',
+    # cache
+    'ResultCache', 'CacheStatistics', 'enable_result_cache', 'disable_result_cache', 'get_result_cache',
+    # lazy
+    'LazyTemporal', 'LazyCollection',
+    # shared
+    'SharedTemporalCollection',
+    # table
+    'MovingObjectTable', 'TableQuery',
+    # processing
+    'TemporalSmoother',
+    'TrajectoryCleaner',
+    'CleaningResult',
+    'SnapshotIndex', 'Snapshot', 'SnapshotFrames',
+    'NearestFeatureIndex',
+    'OriginDestination', 'ODMatrix',
+    'CellGrid', 'QuadGrid', 'GeohashGrid',
+    'MultiBox',
+    'GeoMeasure',
+    'TripsExport', 'TripBuffers',
+    'ContinuousQueryEngine', 'StreamEvent',
+    'QualityProfiler', 'QualityProfile',
+    'BulkSerializer',
+    'AppendableTrajectory', 'AppendableTFloat',
+    'BatchUpsert',
+    'PeriodSweep', 'PeriodBounds',
+    'TrajectoryGenerator', 'SyntheticPoints',
+    'TrajectorySimilarityIndex',
+    'MultiAttributeTrajectory',
 ]
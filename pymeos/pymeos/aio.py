@@ -0,0 +1,184 @@
+"""
+Awaitable versions of expensive PyMEOS operations.
+
+The operations run on a managed thread pool, so the event loop keeps serving other coroutines while they run. The
+number of submitted operations is bounded (backpressure), and cancelling an awaiting task cancels the operation if it
+has not started yet, otherwise its result is discarded.
+
+    >>> from pymeos import aio
+    >>> distance = await aio.frechet_distance(trip1, trip2)
+"""
+import asyncio
+import os
+import weakref
+from concurrent.futures import ThreadPoolExecutor
+from functools import partial
+from typing import AsyncIterable, AsyncIterator, Callable, Iterable, List, Optional, TypeVar, Union
+
+T = TypeVar('T')
+R = TypeVar('R')
+
+
+class AsyncExecutor:
+    """
+    Thread pool for awaitable operations, admitting at most ``max_pending`` submitted operations (queued or
+    running) at a time. Further submissions wait until a slot is released.
+    """
+
+    def __init__(self, max_workers: Optional[int] = None, max_pending: Optional[int] = None):
+        # Default of ThreadPoolExecutor since Python 3.8, resolved here to bound the pending operations
+        self.max_workers = max_workers or min(32, (os.cpu_count() or 1) + 4)
+        self._executor = ThreadPoolExecutor(max_workers=self.max_workers, thread_name_prefix='pymeos-aio')
+        self.max_pending = max_pending or 4 * self.max_workers
+        self._semaphores = weakref.WeakKeyDictionary()
+
+    def _semaphore(self) -> asyncio.Semaphore:
+        # Semaphores are bound to the event loop that uses them
+        loop = asyncio.get_running_loop()
+        semaphore = self._semaphores.get(loop)
+        if semaphore is None:
+            semaphore = self._semaphores[loop] = asyncio.Semaphore(self.max_pending)
+        return semaphore
+
+    async def run(self, function: Callable[..., R], *args, **kwargs) -> R:
+        """
+        Runs ``function`` on the pool and waits for its result.
+        """
+        async with self._semaphore():
+            loop = asyncio.get_running_loop()
+            return await loop.run_in_executor(self._executor, partial(function, *args, **kwargs))
+
+    async def map(self, function: Callable[[T], R], items: Iterable[T]) -> List[R]:
+        """
+        Applies ``function`` to every item and returns the results in the input order. If one of the calls
+        fails or the task is cancelled, the pending calls are cancelled.
+        """
+        return [r async for r in self.pipeline(function, items)]
+
+    async def pipeline(self, function: Callable[[T], R],
+                       items: Union[Iterable[T], AsyncIterable[T]]) -> AsyncIterator[R]:
+        """
+        Applies ``function`` to the items as they are produced, yielding the results in the input order. At most
+        ``max_pending`` results are submitted and not yet consumed, so slow consumers throttle the producer.
+        """
+        semaphore = self._semaphore()
+        loop = asyncio.get_running_loop()
+        pending = asyncio.Queue()
+        done = object()
+
+        async def submit(item):
+            await semaphore.acquire()
+            await pending.put(loop.run_in_executor(self._executor, function, item))
+
+        async def produce():
+            try:
+                if hasattr(items, '__aiter__'):
+                    async for item in items:
+                        await submit(item)
+                else:
+                    for item in items:
+                        await submit(item)
+            finally:
+                await pending.put(done)
+
+        producer = asyncio.ensure_future(produce())
+        try:
+            while True:
+                future = await pending.get()
+                if future is done:
+                    break
+                try:
+                    result = await future
+                finally:
+                    semaphore.release()
+                yield result
+            await producer
+        finally:
+            producer.cancel()
+            while not pending.empty():
+                future = pending.get_nowait()
+                if future is not done:
+                    future.cancel()
+                    semaphore.release()
+
+    def shutdown(self, wait: bool = True) -> None:
+        self._executor.shutdown(wait=wait)
+
+
+_executor: Optional[AsyncExecutor] = None
+
+
+def get_executor() -> AsyncExecutor:
+    """
+    Returns the executor used by the module functions, creating a default one on first use.
+    """
+    global _executor
+    if _executor is None:
+        _executor = AsyncExecutor()
+    return _executor
+
+
+def set_executor(executor: AsyncExecutor) -> None:
+    """
+    Replaces the executor used by the module functions. The previous one is not shut down.
+    """
+    global _executor
+    _executor = executor
+
+
+async def run(function: Callable[..., R], *args, **kwargs) -> R:
+    """
+    Runs any blocking function on the shared executor.
+    """
+    return await get_executor().run(function, *args, **kwargs)
+
+
+async def map_async(function: Callable[[T], R], items: Iterable[T]) -> List[R]:
+    """
+    Applies ``function`` to every item on the shared executor and returns the results in the input order.
+    """
+    return await get_executor().map(function, items)
+
+
+def pipeline(function: Callable[[T], R], items: Union[Iterable[T], AsyncIterable[T]]) -> AsyncIterator[R]:
+    """
+    Applies ``function`` to the items as they are produced on the shared executor. See
+    :meth:`AsyncExecutor.pipeline`.
+    """
+    return get_executor().pipeline(function, items)
+
+
+async def simplify(tpoint, tolerance: float, synchronized: bool = False):
+    return await run(tpoint.simplify, tolerance, synchronized)
+
+
+async def within_distance(tpoint, other, distance: float):
+    return await run(tpoint.within_distance, other, distance)
+
+
+async def nearest_approach_distance(tpoint, other) -> float:
+    return await run(tpoint.nearest_approach_distance, other)
+
+
+async def frechet_distance(temporal, other) -> float:
+    return await run(temporal.frechet_distance, other)
+
+
+async def dyntimewarp_distance(temporal, other) -> float:
+    return await run(temporal.dyntimewarp_distance, other)
+
+
+async def simplify_batch(tpoints: Iterable, tolerance: float, synchronized: bool = False) -> List:
+    return await map_async(lambda t: t.simplify(tolerance, synchronized), tpoints)
+
+
+async def within_distance_batch(tpoints: Iterable, other, distance: float) -> List:
+    return await map_async(lambda t: t.within_distance(other, distance), tpoints)
+
+
+async def frechet_distance_batch(temporals: Iterable, other) -> List[float]:
+    return await map_async(lambda t: t.frechet_distance(other), temporals)
+
+
+async def dyntimewarp_distance_batch(temporals: Iterable, other) -> List[float]:
+    return await map_async(lambda t: t.dyntimewarp_distance(other), temporals)
@@ -0,0 +1,87 @@
+from datetime import datetime
+from typing import List, Union, Sequence
+
+import numpy as np
+from pymeos_cffi import *
+
+# MEOS timestamps (TimestampTz) are microseconds since the PostgreSQL epoch (2000-01-01 00:00:00 UTC)
+PG_EPOCH = np.datetime64('2000-01-01T00:00:00', 'us')
+
+
+def timestamptz_array_to_datetime64(timestamps: Union[Sequence[int], np.ndarray]) -> np.ndarray:
+    """
+    Converts MEOS timestamps into a ``datetime64[us]`` array (UTC).
+    """
+    return PG_EPOCH + np.asarray(timestamps, dtype=np.int64).astype('timedelta64[us]')
+
+
+def datetime64_to_timestamptz_array(timestamps: np.ndarray) -> np.ndarray:
+    """
+    Converts a ``datetime64`` array (UTC) into an ``int64`` array of MEOS timestamps.
+    """
+    return (np.asarray(timestamps).astype('datetime64[us]') - PG_EPOCH).astype(np.int64)
+
+
+def to_timestamptz_list(timestamps: Union[np.ndarray, Sequence[Union[datetime, str, int]]]) -> List[int]:
+    """
+    Converts timestamps given as a ``datetime64`` array, an array of MEOS timestamps or a list of ``datetime``,
+    ``datetime64`` or ``str`` into a list of MEOS timestamps.
+    """
+    if isinstance(timestamps, np.ndarray):
+        if np.issubdtype(timestamps.dtype, np.datetime64):
+            return datetime64_to_timestamptz_array(timestamps).tolist()
+        return timestamps.astype(np.int64).tolist()
+    return [datetime_to_timestamptz(t) if isinstance(t, datetime)
+            else pg_timestamptz_in(t, -1) if isinstance(t, str)
+            else int(datetime64_to_timestamptz_array(t)) if isinstance(t, np.datetime64)
+            else int(t) for t in timestamps]
+
+
+def temporal_instant_timestamps(inner) -> np.ndarray:
+    """
+    MEOS timestamps of every instant of the temporal value, including the repeated bound
+    instants of consecutive sequences of a sequence set.
+    """
+    ins, count = temporal_instants(inner)
+    return np.fromiter((ins[i].t for i in range(count)), dtype=np.int64, count=count)
+
+
+def tfloat_instant_values(inner) -> np.ndarray:
+    """
+    Values of every instant of a temporal float.
+    """
+    ins, count = temporal_instants(inner)
+    return np.fromiter((tfloat_start_value(ins[i]) for i in range(count)), dtype=np.float64, count=count)
+
+
+def tint_instant_values(inner) -> np.ndarray:
+    """
+    Values of every instant of a temporal integer.
+    """
+    ins, count = temporal_instants(inner)
+    return np.fromiter((tint_start_value(ins[i]) for i in range(count)), dtype=np.int64, count=count)
+
+
+def tbool_instant_values(inner) -> np.ndarray:
+    """
+    Values of every instant of a temporal boolean.
+    """
+    ins, count = temporal_instants(inner)
+    return np.fromiter((tbool_start_value(ins[i]) for i in range(count)), dtype=bool, count=count)
+
+
+def tpoint_instant_coordinates(inner, hasz: bool) -> np.ndarray:
+    """
+    X, Y and, when ``hasz`` is true, Z coordinates of every instant of a temporal point, as an array of shape
+    ``(count, 2)`` or ``(count, 3)``. The points are decoded instant by instant, so that the rows match the
+    timestamps of :func:`temporal_instant_timestamps` even where the value is constant along an axis.
+    """
+    ins, count = temporal_instants(inner)
+    coordinates = np.empty((count, 3 if hasz else 2), dtype=np.float64)
+    for i in range(count):
+        point = lwgeom_as_lwpoint(lwgeom_from_gserialized(tpoint_start_value(ins[i])))
+        coordinates[i, 0] = lwpoint_get_x(point)
+        coordinates[i, 1] = lwpoint_get_y(point)
+        if hasz:
+            coordinates[i, 2] = lwpoint_get_z(point)
+    return coordinates
@@ -31,6 +31,7 @@ from pymeos_cffi import *
 from spans import intrange, floatrange
 
 from ..main import TNumber
+from ..number import Span, FloatSpan
 from ..time import *
 
 
@@ -72,8 +73,10 @@ class TBox:
         return tbox_as_hexwkb(self._inner, -1)[0]
 
     @staticmethod
-    def from_value(value: Union[int, float, intrange, floatrange]) -> TBox:
-        if isinstance(value, int):
+    def from_value(value: Union[int, float, Span, intrange, floatrange]) -> TBox:
+        if isinstance(value, Span):
+            result = span_to_tbox(value._inner)
+        elif isinstance(value, int):
             result = int_to_tbox(value)
         elif isinstance(value, float):
             result = float_to_tbox(value)
@@ -100,9 +103,13 @@ class TBox:
         return TBox(_inner=result)
 
     @staticmethod
-    def from_value_time(value: Union[int, float, intrange, floatrange],
+    def from_value_time(value: Union[int, float, Span, intrange, floatrange],
                         time: Union[datetime, Period]) -> TBox:
-        if isinstance(value, int) and isinstance(time, datetime):
+        if isinstance(value, Span) and isinstance(time, datetime):
+            result = span_timestamp_to_tbox(value._inner, datetime_to_timestamptz(time))
+        elif isinstance(value, Span) and isinstance(time, Period):
+            result = span_period_to_tbox(value._inner, time._inner)
+        elif isinstance(value, int) and isinstance(time, datetime):
             result = int_timestamp_to_tbox(value, datetime_to_timestamptz(time))
         elif isinstance(value, int) and isinstance(time, Period):
             result = int_period_to_tbox(value, time)
@@ -146,6 +153,9 @@ class TBox:
     def to_floatrange(self) -> floatrange:
         return floatspan_to_floatrange(tbox_to_floatspan(self._inner))
 
+    def to_floatspan(self) -> FloatSpan:
+        return FloatSpan(_inner=tbox_to_floatspan(self._inner))
+
     def to_period(self) -> Period:
         return Period(_inner=tbox_to_period(self._inner))
 
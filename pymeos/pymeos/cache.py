@@ -0,0 +1,174 @@
+from collections import OrderedDict
+from dataclasses import dataclass
+from functools import wraps
+from threading import Lock
+from typing import Any, Callable, Hashable, Optional, Tuple
+
+from pymeos_cffi import temporal_eq, temporal_hash, temporal_num_instants
+
+# Rough per-object and per-instant footprint used to account the memory retained by the cache
+_OBJECT_SIZE = 64
+_INSTANT_SIZE = 48
+
+
+@dataclass(frozen=True)
+class CacheStatistics:
+    hits: int
+    misses: int
+    collisions: int
+    evictions: int
+    entries: int
+    memory: int
+
+    @property
+    def hit_rate(self) -> float:
+        lookups = self.hits + self.misses
+        return self.hits / lookups if lookups else 0.0
+
+
+class ResultCache:
+    """
+    Bounded LRU cache of the results of expensive pairwise operations.
+
+    Entries are keyed by the operation, the ``temporal_hash`` of the temporal operands and the remaining
+    parameters. As hashes may collide, a hit is only returned after confirming that the stored operands are
+    equal to the given ones. The cache keeps references to its operands and results, and evicts the least
+    recently used entries when either ``max_entries`` or the approximate ``max_memory`` (bytes) is exceeded.
+    """
+
+    def __init__(self, max_entries: int = 10000, max_memory: int = 64 * 1024 * 1024):
+        if max_entries < 1 or max_memory < 1:
+            raise ValueError('The cache limits must be positive')
+        self.max_entries = max_entries
+        self.max_memory = max_memory
+        self._entries = OrderedDict()
+        self._memory = 0
+        self._lock = Lock()
+        self._hits = 0
+        self._misses = 0
+        self._collisions = 0
+        self._evictions = 0
+
+    @property
+    def statistics(self) -> CacheStatistics:
+        with self._lock:
+            return CacheStatistics(self._hits, self._misses, self._collisions, self._evictions, len(self._entries),
+                                   self._memory)
+
+    def clear(self) -> None:
+        with self._lock:
+            self._entries.clear()
+            self._memory = 0
+            self._hits = self._misses = self._collisions = self._evictions = 0
+
+    def get_or_compute(self, operation: str, operands: Tuple[Any, ...], parameters: Tuple[Any, ...],
+                       function: Callable[[], Any]) -> Any:
+        """
+        Returns the cached result of ``operation`` over ``operands`` and ``parameters``, calling ``function`` to
+        compute and store it on a miss.
+        """
+        key = (operation, tuple(_operand_key(o) for o in operands), parameters)
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is not None:
+                if _same_operands(entry[0], operands):
+                    self._entries.move_to_end(key)
+                    self._hits += 1
+                    return entry[1]
+                self._collisions += 1
+            self._misses += 1
+        # Computed outside the lock so that other threads are not blocked by the MEOS call
+        result = function()
+        size = sum(_estimate_size(o) for o in operands) + _estimate_size(result)
+        with self._lock:
+            previous = self._entries.pop(key, None)
+            if previous is not None:
+                self._memory -= previous[2]
+            self._entries[key] = (operands, result, size)
+            self._memory += size
+            while len(self._entries) > self.max_entries or (self._memory > self.max_memory and len(self._entries) > 1):
+                _, evicted = self._entries.popitem(last=False)
+                self._memory -= evicted[2]
+                self._evictions += 1
+        return result
+
+
+_cache: Optional[ResultCache] = None
+
+
+def enable_result_cache(max_entries: int = 10000, max_memory: int = 64 * 1024 * 1024) -> ResultCache:
+    """
+    Enables caching of ``frechet_distance``, ``dyntimewarp_distance``, ``nearest_approach_distance`` and
+    ``within_distance`` with a new :class:`ResultCache`, which is returned.
+    """
+    global _cache
+    _cache = ResultCache(max_entries, max_memory)
+    return _cache
+
+
+def disable_result_cache() -> None:
+    """
+    Disables result caching and releases the cached results.
+    """
+    global _cache
+    _cache = None
+
+
+def get_result_cache() -> Optional[ResultCache]:
+    """
+    Returns the active result cache, or ``None`` if caching is disabled.
+    """
+    return _cache
+
+
+def cached_operation(operation: str) -> Callable:
+    """
+    Decorator caching the results of a method taking another operand and optional extra positional or keyword
+    parameters when the result cache is enabled.
+    """
+
+    def decorator(method: Callable) -> Callable:
+        @wraps(method)
+        def wrapper(self, other, *args, **kwargs):
+            cache = _cache
+            if cache is None:
+                return method(self, other, *args, **kwargs)
+            # Keyword arguments are part of the key, sorted so that their order does not matter
+            parameters = args + tuple(sorted(kwargs.items()))
+            return cache.get_or_compute(operation, (self, other), parameters,
+                                        lambda: method(self, other, *args, **kwargs))
+
+        return wrapper
+
+    return decorator
+
+
+def _is_temporal(value: Any) -> bool:
+    from .temporal import Temporal
+    return isinstance(value, Temporal)
+
+
+def _operand_key(value: Any) -> Hashable:
+    if _is_temporal(value):
+        return value.__class__.__name__, temporal_hash(value._inner)
+    if hasattr(value, 'wkb'):
+        # shapely geometries
+        return 'wkb', value.wkb
+    if hasattr(value, 'to_ewkb'):
+        # postgis geometries
+        return 'ewkb', value.to_ewkb()
+    if hasattr(value, 'as_hexwkb'):
+        # boxes and time types
+        return value.__class__.__name__, value.as_hexwkb()
+    return value
+
+
+def _same_operands(stored: Tuple[Any, ...], given: Tuple[Any, ...]) -> bool:
+    # Only temporal values are keyed by a hash, the other operands are keyed by their full serialization
+    return all(s is g or not _is_temporal(g) or temporal_eq(s._inner, g._inner) for s, g in zip(stored, given))
+
+
+def _estimate_size(value: Any) -> int:
+    if _is_temporal(value):
+        return _OBJECT_SIZE + _INSTANT_SIZE * temporal_num_instants(value._inner)
+    return _OBJECT_SIZE
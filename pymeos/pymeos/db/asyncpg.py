@@ -13,6 +13,37 @@ class MobilityDB:
     @classmethod
     async def register(cls, conn):
         # Add MobilityDB types to PostgreSQL adapter and specify the reader function for each type.
-        classes = [TimestampSet, Period, PeriodSet, TBox, TBool, TInt, TFloat, TText, STBox, TGeomPoint, TGeogPoint]
-        for cl in classes:
+        for cl in cls._classes():
             await conn.set_type_codec(cl.__name__.lower(), encoder=str, decoder=cl.read_from_cursor)
+
+    @classmethod
+    async def stream(cls, conn, query: str, *args, function, prefetch: int = 50, executor=None):
+        """
+        Runs ``query`` with a server-side cursor and yields ``function(row)`` for every row, in order, where ``row``
+        is the tuple of the column values. The MobilityDB values are fetched as text and decoded together with
+        ``function`` on the thread pool of ``executor`` (by default the one of :mod:`pymeos.aio`), so that the event
+        loop only fetches the rows while decoding and computing run in parallel. The connection returns MobilityDB
+        values as text until the stream ends, when the codecs of :meth:`register` are set again.
+        """
+        from ..aio import get_executor
+        executor = executor or get_executor()
+        readers = {cl.__name__.lower(): cl.read_from_cursor for cl in cls._classes()}
+        for name in readers:
+            await conn.set_type_codec(name, encoder=str, decoder=str)
+        try:
+            async with conn.transaction():
+                statement = await conn.prepare(query)
+                columns = [readers.get(attribute.type.name) for attribute in statement.get_attributes()]
+
+                def decode_and_apply(row):
+                    return function(tuple(value if reader is None or value is None else reader(value)
+                                          for reader, value in zip(columns, row)))
+
+                async for result in executor.pipeline(decode_and_apply, statement.cursor(*args, prefetch=prefetch)):
+                    yield result
+        finally:
+            await cls.register(conn)
+
+    @staticmethod
+    def _classes():
+        return [TimestampSet, Period, PeriodSet, TBox, TBool, TInt, TFloat, TText, STBox, TGeomPoint, TGeogPoint]
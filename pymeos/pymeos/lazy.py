@@ -0,0 +1,225 @@
+from __future__ import annotations
+
+from typing import Any, Callable, Dict, Iterable, List, Optional, Tuple, Union
+
+from pymeos_cffi import intersection_span_span, intersection_stbox_stbox, stbox_make, stbox_to_period, \
+    overlaps_temporal_period, overlaps_tpoint_stbox
+
+from .boxes import STBox
+from .main import TPoint
+from .parallel import parallel_map
+from .temporal import Temporal
+from .time import Period
+
+# Marker of a plan that is proven empty while fusing its restrictions
+_EMPTY = object()
+
+
+class _Restriction:
+    """
+    ``at`` or ``minus`` step. Consecutive ``at`` steps over periods and boxes are fused into one.
+    """
+
+    def __init__(self, operation: str, value: Any, fused: int = 1):
+        self.operation = operation
+        self.value = value
+        self.fused = fused
+
+    @property
+    def prunable(self) -> bool:
+        return isinstance(self.value, (Period, STBox))
+
+    def apply(self, temporal: Temporal) -> Optional[Temporal]:
+        if self.prunable and not _bbox_overlaps(temporal, self.value):
+            # The stored bounding box proves the restriction empty (at) or a no-op (minus)
+            return None if self.operation == 'at' else temporal
+        return getattr(temporal, self.operation)(self.value)
+
+    def __str__(self):
+        value = 'EMPTY' if self.value is _EMPTY else f'{self.value.__class__.__name__}({self.value})'
+        notes = []
+        if self.fused > 1:
+            notes.append(f'fused {self.fused} restrictions')
+        if self.prunable:
+            notes.append('bounding box pushdown')
+        return f'{self.operation} {value}' + (f'  [{", ".join(notes)}]' if notes else '')
+
+
+class _Call:
+    """
+    Any other method call, executed as is.
+    """
+
+    def __init__(self, name: str, args: Tuple, kwargs: Dict[str, Any]):
+        self.name = name
+        self.args = args
+        self.kwargs = kwargs
+
+    def apply(self, temporal: Temporal) -> Any:
+        return getattr(temporal, self.name)(*self.args, **self.kwargs)
+
+    def __str__(self):
+        arguments = [repr(a) for a in self.args] + [f'{k}={v!r}' for k, v in self.kwargs.items()]
+        return f'{self.name}({", ".join(arguments)})'
+
+
+_Step = Union[_Restriction, _Call]
+
+
+def _bbox_overlaps(temporal: Temporal, value: Union[Period, STBox]) -> bool:
+    if isinstance(value, Period):
+        return overlaps_temporal_period(temporal._inner, value._inner)
+    if isinstance(temporal, TPoint):
+        return overlaps_tpoint_stbox(temporal._inner, value._inner)
+    # Restricting other types to a box is not supported, let the method raise the error
+    return True
+
+
+def _fuse(first: Union[Period, STBox], second: Union[Period, STBox]):
+    """
+    Intersection of two restrictions, ``_EMPTY`` if they are disjoint, or ``None`` if they cannot be fused because
+    they are boxes with different dimensions.
+    """
+    if isinstance(first, Period) and isinstance(second, Period):
+        result = intersection_span_span(first._inner, second._inner)
+        return Period(_inner=result) if result is not None else _EMPTY
+    if isinstance(first, STBox) and isinstance(second, STBox):
+        # The intersection of boxes only keeps the dimensions they share, which would drop a restriction
+        if (first.has_xy, first.has_z, first.has_t, first.geodetic) != \
+                (second.has_xy, second.has_z, second.has_t, second.geodetic):
+            return None
+        result = intersection_stbox_stbox(first._inner, second._inner)
+        return STBox(_inner=result) if result is not None else _EMPTY
+    period, box = (first, second) if isinstance(first, Period) else (second, first)
+    p = period._inner
+    if box.has_t:
+        p = intersection_span_span(p, stbox_to_period(box._inner))
+        if p is None:
+            return _EMPTY
+    if not box.has_xy:
+        return Period(_inner=p)
+    hasz = box.has_z
+    return STBox(_inner=stbox_make(p, True, hasz, box.geodetic, box.srid, box.xmin, box.xmax, box.ymin, box.ymax,
+                                   box.zmin if hasz else 0.0, box.zmax if hasz else 0.0))
+
+
+class _LazyExpression:
+    """
+    Records method calls on temporal values without executing them.
+    """
+
+    def __init__(self, steps: Tuple[_Step, ...] = ()):
+        self._steps = steps
+
+    def _with(self, step: _Step):
+        raise NotImplementedError()
+
+    def at(self, other: Any):
+        return self._with(_Restriction('at', other))
+
+    def minus(self, other: Any):
+        return self._with(_Restriction('minus', other))
+
+    def __getattr__(self, name: str) -> Callable[..., Any]:
+        if name.startswith('_'):
+            raise AttributeError(name)
+        return lambda *args, **kwargs: self._with(_Call(name, args, kwargs))
+
+    def plan(self) -> List[_Step]:
+        """
+        Steps that will be executed, after fusing consecutive ``at`` restrictions over periods and boxes.
+        """
+        plan = []
+        for step in self._steps:
+            previous = plan[-1] if plan else None
+            if isinstance(step, _Restriction) and step.operation == 'at' and step.prunable and \
+                    isinstance(previous, _Restriction) and previous.operation == 'at' and \
+                    (previous.prunable or previous.value is _EMPTY):
+                value = _EMPTY if previous.value is _EMPTY else _fuse(previous.value, step.value)
+                if value is not None:
+                    plan[-1] = _Restriction('at', value, previous.fused + 1)
+                    continue
+            plan.append(step)
+        return plan
+
+    def _run(self, plan: List[_Step], temporal: Temporal) -> Any:
+        value = temporal
+        for step in plan:
+            if isinstance(step, _Restriction) and step.value is _EMPTY:
+                return None
+            value = step.apply(value)
+            if value is None:
+                return None
+        return value
+
+    def _explain_steps(self, plan: List[_Step]) -> List[str]:
+        lines = [f'  {i}. {step}' for i, step in enumerate(plan, 1)]
+        if any(isinstance(step, _Restriction) and step.value is _EMPTY for step in plan):
+            lines.append('  The restrictions are disjoint: the result is empty and no data is read.')
+        return lines
+
+
+class LazyTemporal(_LazyExpression):
+    """
+    Lazy expression over a temporal value, created with :meth:`Temporal.lazy`.
+
+    Method calls are recorded and run by :meth:`collect`. Consecutive ``at`` restrictions over periods and
+    boxes are intersected into a single restriction, unless they are boxes with different dimensions, and every
+    period or box restriction is first checked against the bounding box stored in the temporal value: when they do
+    not overlap, ``at`` returns ``None`` and ``minus`` returns the value itself without calling MEOS.
+
+        >>> traj.lazy().at(period).at(stbox).speed().at_max().collect()
+    """
+
+    def __init__(self, source: Temporal, steps: Tuple[_Step, ...] = ()):
+        super().__init__(steps)
+        self._source = source
+
+    def _with(self, step: _Step) -> LazyTemporal:
+        return LazyTemporal(self._source, self._steps + (step,))
+
+    def collect(self) -> Any:
+        """
+        Executes the plan. Returns ``None`` if a restriction leaves the value empty.
+        """
+        return self._run(self.plan(), self._source)
+
+    def explain(self) -> str:
+        """
+        Textual description of the execution plan.
+        """
+        return '\n'.join([f'Plan over {self._source.__class__.__name__}:'] + self._explain_steps(self.plan()))
+
+    def __repr__(self):
+        return f'{self.__class__.__name__}({len(self._steps)} steps)'
+
+
+class LazyCollection(_LazyExpression):
+    """
+    Lazy expression applied to every temporal value of a collection. See :class:`LazyTemporal`.
+    """
+
+    def __init__(self, sources: Iterable[Temporal], steps: Tuple[_Step, ...] = ()):
+        super().__init__(steps)
+        self._sources = list(sources)
+
+    def _with(self, step: _Step) -> LazyCollection:
+        return LazyCollection(self._sources, self._steps + (step,))
+
+    def collect(self, keep_empty: bool = False, max_workers: Optional[int] = None) -> List[Any]:
+        """
+        Executes the plan on every value on a thread pool. Empty results are discarded unless ``keep_empty``
+        is set, in which case they are returned as ``None`` in the input order.
+        """
+        plan = self.plan()
+        results = parallel_map(lambda temporal: self._run(plan, temporal), self._sources, max_workers)
+        return results if keep_empty else [r for r in results if r is not None]
+
+    def explain(self) -> str:
+        """
+        Textual description of the execution plan.
+        """
+        return '\n'.join([f'Plan over {len(self._sources)} temporal values:'] + self._explain_steps(self.plan()))
+
+    def __repr__(self):
+        return f'{self.__class__.__name__}({len(self._sources)} values, {len(self._steps)} steps)'
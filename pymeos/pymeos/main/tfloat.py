@@ -26,12 +26,14 @@
 from __future__ import annotations
 
 from abc import ABC
-from typing import Optional, List, Union, TYPE_CHECKING, Set
+from typing import Optional, List, Union, TYPE_CHECKING, Set, Tuple
 
+import numpy as np
 from pymeos_cffi import *
 from spans.types import floatrange, intrange
 
 from .tnumber import TNumber
+from ..number import FloatSpan, FloatSpanSet
 from ..temporal import TInterpolation, Temporal, TInstant, TSequence, TSequenceSet
 from ..time import *
 
@@ -209,6 +211,9 @@ class TFloat(TNumber[float, 'TFloat', 'TFloatInst', 'TFloatSeq', 'TFloatSeqSet']
     def to_floatrange(self) -> floatrange:
         return floatspan_to_floatrange(tnumber_to_span(self._inner))
 
+    def to_floatspan(self) -> FloatSpan:
+        return FloatSpan(_inner=tnumber_to_span(self._inner))
+
     @staticmethod
     def from_base(value: float, base: Temporal, interpolation: TInterpolation = TInterpolation.LINEAR) -> TFloat:
         result = tfloat_from_base(value, base._inner, interpolation)
@@ -259,6 +264,21 @@ class TFloat(TNumber[float, 'TFloat', 'TFloatInst', 'TFloatSeq', 'TFloatSeqSet']
         spans, count = tfloat_spans(self._inner)
         return [floatspan_to_floatrange(spans[i]) for i in range(count)]
 
+    @property
+    def value_span(self) -> FloatSpan:
+        """
+        Span of values taken by the temporal value as defined by its minimum and maximum value
+        """
+        return self.to_floatspan()
+
+    @property
+    def value_spans(self) -> FloatSpanSet:
+        """
+        Set of spans of values taken by the temporal value
+        """
+        spans, count = tfloat_spans(self._inner)
+        return FloatSpanSet([FloatSpan(_inner=spans[i]) for i in range(count)], normalize=False)
+
     @property
     def start_value(self) -> float:
         """
@@ -317,6 +337,36 @@ class TFloat(TNumber[float, 'TFloat', 'TFloatInst', 'TFloatSeq', 'TFloatSeqSet']
         tiles, new_count = tfloat_value_time_split(self._inner, value_size, value_start, dt, st)
         return [Temporal._factory(tiles[i]) for i in range(new_count)]
 
+    def to_arrays(self) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Timestamps (``datetime64[us]``, UTC) and values of the instants as numpy arrays.
+        """
+        from ..arrays import temporal_instant_timestamps, timestamptz_array_to_datetime64, tfloat_instant_values
+        return timestamptz_array_to_datetime64(temporal_instant_timestamps(self._inner)), \
+            tfloat_instant_values(self._inner)
+
+    def kalman_filter(self, process_noise: float = 1.0, measurement_noise: float = 1.0,
+                      smooth: bool = True) -> TFloat:
+        """
+        Smooths the values with a constant-velocity Kalman filter, keeping timestamps and interpolation.
+        """
+        from ..processing import TemporalSmoother
+        return TemporalSmoother.kalman(self, process_noise, measurement_noise, smooth)
+
+    def savitzky_golay_filter(self, window: int = 5, order: int = 2) -> TFloat:
+        """
+        Smooths the values with a Savitzky-Golay filter fitted on the actual timestamps.
+        """
+        from ..processing import TemporalSmoother
+        return TemporalSmoother.savitzky_golay(self, window, order)
+
+    def median_filter(self, window: int = 5) -> TFloat:
+        """
+        Smooths the values with a rolling median.
+        """
+        from ..processing import TemporalSmoother
+        return TemporalSmoother.median(self, window)
+
     def to_degrees(self) -> TNumber:
         from ..factory import _TemporalFactory
         return _TemporalFactory.create_temporal(tfloat_degrees(self._inner))
@@ -350,6 +400,17 @@ class TFloatSeq(TSequence[float, 'TFloat', 'TFloatInst', 'TFloatSeq', 'TFloatSeq
         super().__init__(string=string, instant_list=instant_list, lower_inc=lower_inc, upper_inc=upper_inc,
                          expandable=expandable, interpolation=interpolation, normalize=normalize, _inner=_inner)
 
+    @staticmethod
+    def from_arrays(t: Union[List[Union[datetime, str]], np.ndarray], values: Union[List[float], np.ndarray],
+                    lower_inc: bool = True, upper_inc: bool = False,
+                    interpolation: TInterpolation = TInterpolation.LINEAR, normalize: bool = True) -> TFloatSeq:
+        from ..arrays import to_timestamptz_list
+        assert len(t) == len(values)
+        times = to_timestamptz_list(t)
+        instants = [tfloatinst_make(v, ti) for v, ti in zip(np.asarray(values, dtype=float).tolist(), times)]
+        return TFloatSeq(_inner=tsequence_make(instants, len(instants), lower_inc, upper_inc, interpolation,
+                                               normalize))
+
 
 class TFloatSeqSet(TSequenceSet[float, 'TFloat', 'TFloatInst', 'TFloatSeq', 'TFloatSeqSet'], TFloat):
     ComponentClass = TFloatSeq
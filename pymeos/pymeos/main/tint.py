@@ -26,12 +26,14 @@
 from __future__ import annotations
 
 from abc import ABC
-from typing import Optional, Union, List, TYPE_CHECKING, Set
+from typing import Optional, Union, List, TYPE_CHECKING, Set, Tuple
 
+import numpy as np
 from pymeos_cffi import *
 from spans.types import intrange, floatrange
 
 from .tnumber import TNumber
+from ..number import IntSpan
 from ..temporal import TInterpolation, Temporal, TInstant, TSequence, TSequenceSet
 from ..time import *
 
@@ -217,6 +219,17 @@ class TInt(TNumber[int, 'TInt', 'TIntInst', 'TIntSeq', 'TIntSeqSet'], ABC):
     def to_intrange(self) -> intrange:
         return intspan_to_intrange(tnumber_to_span(self._inner))
 
+    def to_intspan(self) -> IntSpan:
+        return IntSpan(_inner=tnumber_to_span(self._inner))
+
+    def to_arrays(self) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Timestamps (``datetime64[us]``, UTC) and values of the instants as numpy arrays.
+        """
+        from ..arrays import temporal_instant_timestamps, timestamptz_array_to_datetime64, tint_instant_values
+        return timestamptz_array_to_datetime64(temporal_instant_timestamps(self._inner)), \
+            tint_instant_values(self._inner)
+
     @staticmethod
     def from_base(value: int, base: Temporal) -> TInt:
         result = tint_from_base(value, base._inner)
@@ -256,6 +269,13 @@ class TInt(TNumber[int, 'TInt', 'TIntInst', 'TIntSeq', 'TIntSeqSet'], ABC):
         """
         return self.to_intrange()
 
+    @property
+    def value_span(self) -> IntSpan:
+        """
+        Span of values taken by the temporal value as defined by its minimum and maximum value
+        """
+        return self.to_intspan()
+
     @property
     def start_value(self) -> int:
         """
@@ -335,6 +355,17 @@ class TIntSeq(TSequence[int, 'TInt', 'TIntInst', 'TIntSeq', 'TIntSeqSet'], TInt)
         super().__init__(string=string, instant_list=instant_list, lower_inc=lower_inc, upper_inc=upper_inc,
                          expandable=expandable, interpolation=interpolation, normalize=normalize, _inner=_inner)
 
+    @staticmethod
+    def from_arrays(t: Union[List[Union[datetime, str]], np.ndarray], values: Union[List[int], np.ndarray],
+                    lower_inc: bool = True, upper_inc: bool = False,
+                    interpolation: TInterpolation = TInterpolation.STEPWISE, normalize: bool = True) -> TIntSeq:
+        from ..arrays import to_timestamptz_list
+        assert len(t) == len(values)
+        times = to_timestamptz_list(t)
+        instants = [tintinst_make(v, ti) for v, ti in zip(np.asarray(values, dtype=np.int64).tolist(), times)]
+        return TIntSeq(_inner=tsequence_make(instants, len(instants), lower_inc, upper_inc, interpolation,
+                                             normalize))
+
 
 class TIntSeqSet(TSequenceSet[int, 'TInt', 'TIntInst', 'TIntSeq', 'TIntSeqSet'], TInt):
     ComponentClass = TIntSeq
@@ -7,6 +7,7 @@ from typing import Union, List, TYPE_CHECKING, TypeVar
 from pymeos_cffi import *
 from spans import intrange, floatrange
 
+from ..number import Span, SpanSet
 from ..temporal import Temporal
 
 if TYPE_CHECKING:
@@ -23,12 +24,14 @@ TSS = TypeVar('TSS', 'TSequenceSet[int]', 'TSequenceSet[float]')
 
 class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
 
-    def is_adjacent(self, other: Union[TBox, TNumber, floatrange, intrange,
+    def is_adjacent(self, other: Union[TBox, TNumber, Span, floatrange, intrange,
                                        Period, PeriodSet, datetime, TimestampSet, Temporal]) -> bool:
         if isinstance(other, TBox):
             return adjacent_tnumber_tbox(self._inner, other._inner)
         elif isinstance(other, TNumber):
             return adjacent_tnumber_tnumber(self._inner, other._inner)
+        elif isinstance(other, Span):
+            return adjacent_tnumber_span(self._inner, other._inner)
         elif isinstance(other, floatrange):
             return adjacent_tnumber_span(self._inner, floatrange_to_floatspan(other))
         elif isinstance(other, intrange):
@@ -36,12 +39,14 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             return super().is_adjacent(other)
 
-    def is_contained_in(self, container: Union[TBox, TNumber, floatrange, intrange,
+    def is_contained_in(self, container: Union[TBox, TNumber, Span, floatrange, intrange,
                                                Period, PeriodSet, datetime, TimestampSet, Temporal]) -> bool:
         if isinstance(container, TBox):
             return contained_tnumber_tbox(self._inner, container._inner)
         elif isinstance(container, TNumber):
             return contained_tnumber_tnumber(self._inner, container._inner)
+        elif isinstance(container, Span):
+            return contained_tnumber_span(self._inner, container._inner)
         elif isinstance(container, floatrange):
             return contained_tnumber_span(self._inner, floatrange_to_floatspan(container))
         elif isinstance(container, intrange):
@@ -49,12 +54,14 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             return super().is_contained_in(container)
 
-    def contains(self, content: Union[TBox, TNumber, floatrange, intrange,
+    def contains(self, content: Union[TBox, TNumber, Span, floatrange, intrange,
                                       Period, PeriodSet, datetime, TimestampSet, Temporal]) -> bool:
         if isinstance(content, TBox):
             return contains_tnumber_tbox(self._inner, content._inner)
         elif isinstance(content, TNumber):
             return contains_tnumber_tnumber(self._inner, content._inner)
+        elif isinstance(content, Span):
+            return contains_tnumber_span(self._inner, content._inner)
         elif isinstance(content, floatrange):
             return contains_tnumber_span(self._inner, floatrange_to_floatspan(content))
         elif isinstance(content, intrange):
@@ -62,11 +69,13 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             return super().contains(content)
 
-    def is_left(self, other: Union[int, float, intrange, floatrange, TBox, TNumber]) -> bool:
+    def is_left(self, other: Union[int, float, Span, intrange, floatrange, TBox, TNumber]) -> bool:
         if isinstance(other, int):
             return left_tint_int(self._inner, other)
         elif isinstance(other, float):
             return left_tfloat_float(self._inner, other)
+        elif isinstance(other, Span):
+            return left_tnumber_span(self._inner, other._inner)
         elif isinstance(other, intrange):
             return left_tnumber_span(self._inner, intrange_to_intspan(other))
         elif isinstance(other, floatrange):
@@ -78,11 +87,13 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             raise TypeError(f'Operation not supported with type {other.__class__}')
 
-    def is_over_or_left(self, other: Union[int, float, intrange, floatrange, TBox, TNumber]) -> bool:
+    def is_over_or_left(self, other: Union[int, float, Span, intrange, floatrange, TBox, TNumber]) -> bool:
         if isinstance(other, int):
             return overleft_tint_int(self._inner, other)
         elif isinstance(other, float):
             return overleft_tfloat_float(self._inner, other)
+        elif isinstance(other, Span):
+            return overleft_tnumber_span(self._inner, other._inner)
         elif isinstance(other, intrange):
             return overleft_tnumber_span(self._inner, intrange_to_intspan(other))
         elif isinstance(other, floatrange):
@@ -94,12 +105,14 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             raise TypeError(f'Operation not supported with type {other.__class__}')
 
-    def overlaps(self, other: Union[TBox, TNumber, floatrange, intrange,
+    def overlaps(self, other: Union[TBox, TNumber, Span, floatrange, intrange,
                                     Period, PeriodSet, datetime, TimestampSet, Temporal]) -> bool:
         if isinstance(other, TBox):
             return overlaps_tnumber_tbox(self._inner, other._inner)
         elif isinstance(other, TNumber):
             return overlaps_tnumber_tnumber(self._inner, other._inner)
+        elif isinstance(other, Span):
+            return overlaps_tnumber_span(self._inner, other._inner)
         elif isinstance(other, floatrange):
             return overlaps_tnumber_span(self._inner, floatrange_to_floatspan(other))
         elif isinstance(other, intrange):
@@ -107,11 +120,13 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             return super().overlaps(other)
 
-    def is_over_or_right(self, other: Union[int, float, intrange, floatrange, TBox, TNumber]) -> bool:
+    def is_over_or_right(self, other: Union[int, float, Span, intrange, floatrange, TBox, TNumber]) -> bool:
         if isinstance(other, int):
             return overright_tint_int(self._inner, other)
         elif isinstance(other, float):
             return overright_tfloat_float(self._inner, other)
+        elif isinstance(other, Span):
+            return overright_tnumber_span(self._inner, other._inner)
         elif isinstance(other, intrange):
             return overright_tnumber_span(self._inner, intrange_to_intspan(other))
         elif isinstance(other, floatrange):
@@ -123,11 +138,13 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             raise TypeError(f'Operation not supported with type {other.__class__}')
 
-    def is_right(self, other: Union[int, float, intrange, floatrange, TBox, TNumber]) -> bool:
+    def is_right(self, other: Union[int, float, Span, intrange, floatrange, TBox, TNumber]) -> bool:
         if isinstance(other, int):
             return right_tint_int(self._inner, other)
         elif isinstance(other, float):
             return right_tfloat_float(self._inner, other)
+        elif isinstance(other, Span):
+            return right_tnumber_span(self._inner, other._inner)
         elif isinstance(other, intrange):
             return right_tnumber_span(self._inner, intrange_to_intspan(other))
         elif isinstance(other, floatrange):
@@ -139,12 +156,14 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             raise TypeError(f'Operation not supported with type {other.__class__}')
 
-    def is_same(self, other: Union[TBox, TNumber, floatrange, intrange,
+    def is_same(self, other: Union[TBox, TNumber, Span, floatrange, intrange,
                                    Period, PeriodSet, datetime, TimestampSet, Temporal]) -> bool:
         if isinstance(other, TBox):
             return same_tnumber_tbox(self._inner, other._inner)
         elif isinstance(other, TNumber):
             return same_tnumber_tnumber(self._inner, other._inner)
+        elif isinstance(other, Span):
+            return same_tnumber_span(self._inner, other._inner)
         elif isinstance(other, floatrange):
             return same_tnumber_span(self._inner, floatrange_to_floatspan(other))
         elif isinstance(other, intrange):
@@ -184,10 +203,19 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
         else:
             raise TypeError(f'Operation not supported with type {other.__class__}')
 
-    def at(self, other: Union[intrange, floatrange, List[intrange], List[floatrange], TBox,
-                              datetime, TimestampSet, Period, PeriodSet]) -> TG:
+    def at(self, other: Union[Span, SpanSet, List[Span], intrange, floatrange, List[intrange], List[floatrange],
+                              TBox, datetime, TimestampSet, Period, PeriodSet]) -> TG:
         from ..boxes import TBox
-        if isinstance(other, intrange):
+        if isinstance(other, (list, SpanSet)) and len(other) == 0:
+            # Nothing is left after restricting to an empty set of spans
+            return None
+        if isinstance(other, Span):
+            result = tnumber_at_span(self._inner, other._inner)
+        elif isinstance(other, SpanSet):
+            result = tnumber_at_spans(self._inner, other._inners, len(other._inners))
+        elif isinstance(other, list) and isinstance(other[0], Span):
+            result = tnumber_at_spans(self._inner, [s._inner for s in other], len(other))
+        elif isinstance(other, intrange):
             result = tnumber_at_span(self._inner, intrange_to_intspan(other))
         elif isinstance(other, floatrange):
             result = tnumber_at_span(self._inner, floatrange_to_floatspan(other))
@@ -203,9 +231,18 @@ class TNumber(Temporal[TBase, TG, TI, TS, TSS], ABC):
             return super().at(other)
         return Temporal._factory(result)
 
-    def minus(self, other: Union[intrange, floatrange, List[intrange], List[floatrange], TBox,
-                                 datetime, TimestampSet, Period, PeriodSet]) -> TG:
-        if isinstance(other, intrange):
+    def minus(self, other: Union[Span, SpanSet, List[Span], intrange, floatrange, List[intrange], List[floatrange],
+                                 TBox, datetime, TimestampSet, Period, PeriodSet]) -> TG:
+        if isinstance(other, (list, SpanSet)) and len(other) == 0:
+            # Subtracting an empty set of spans leaves the value unchanged
+            return self
+        if isinstance(other, Span):
+            result = tnumber_minus_span(self._inner, other._inner)
+        elif isinstance(other, SpanSet):
+            result = tnumber_minus_spans(self._inner, other._inners, len(other._inners))
+        elif isinstance(other, list) and isinstance(other[0], Span):
+            result = tnumber_minus_spans(self._inner, [s._inner for s in other], len(other))
+        elif isinstance(other, intrange):
             result = tnumber_minus_span(self._inner, intrange_to_intspan(other))
         elif isinstance(other, floatrange):
             result = tnumber_minus_span(self._inner, floatrange_to_floatspan(other))
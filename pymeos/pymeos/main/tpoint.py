@@ -29,6 +29,7 @@ from __future__ import annotations
 from abc import ABC
 from typing import Optional, List, TYPE_CHECKING, Set, Tuple, Union, TypeVar
 
+import numpy as np
 import postgis as pg
 import shapely.geometry as shp
 import shapely.geometry.base as shpb
@@ -37,11 +38,15 @@ from pymeos_cffi import *
 
 from .tbool import TBool
 from .tfloat import TFloatSeqSet, TFloat
+from ..cache import cached_operation
 from ..temporal import Temporal, TInstant, TSequence, TSequenceSet, TInterpolation
 from ..time import *
 
 if TYPE_CHECKING:
     from ..boxes import STBox
+    from .tint import TInt
+    from ..processing import NearestFeatureIndex, CellGrid
+    from .ttext import TText
 
 TG = TypeVar('TG', bound='TPoint')
 TI = TypeVar('TI', bound='TPointInst')
@@ -85,9 +90,70 @@ class TPoint(Temporal[shp.Point, TG, TI, TS, TSS], ABC):
         return gserialized_to_shapely_point(
             tpoint_value_at_timestamp(self._inner, datetime_to_timestamptz(timestamp), True)[0], precision)
 
+    def to_arrays(self) -> Tuple[np.ndarray, np.ndarray, np.ndarray, Optional[np.ndarray]]:
+        """
+        Timestamps (``datetime64[us]``, UTC) and X, Y and Z coordinates of the instants as numpy arrays.
+        Z is ``None`` for 2D points.
+        """
+        from ..arrays import temporal_instant_timestamps, timestamptz_array_to_datetime64, tpoint_instant_coordinates
+        t = timestamptz_array_to_datetime64(temporal_instant_timestamps(self._inner))
+        coordinates = tpoint_instant_coordinates(self._inner, self.hasz)
+        z = coordinates[:, 2].copy() if self.hasz else None
+        return t, coordinates[:, 0].copy(), coordinates[:, 1].copy(), z
+
     def simplify(self: Self, tolerance: float, synchronized: bool = False) -> Self:
         return self.__class__(_inner=temporal_simplify(self._inner, tolerance, synchronized))
 
+    def kalman_filter(self: Self, process_noise: float = 1.0, measurement_noise: float = 1.0,
+                      smooth: bool = True) -> Self:
+        """
+        Smooths the positions with a constant-velocity Kalman filter, keeping timestamps and interpolation.
+        """
+        from ..processing import TemporalSmoother
+        return TemporalSmoother.kalman(self, process_noise, measurement_noise, smooth)
+
+    def savitzky_golay_filter(self: Self, window: int = 5, order: int = 2) -> Self:
+        """
+        Smooths the positions with a Savitzky-Golay filter fitted on the actual timestamps.
+        """
+        from ..processing import TemporalSmoother
+        return TemporalSmoother.savitzky_golay(self, window, order)
+
+    def median_filter(self: Self, window: int = 5) -> Self:
+        """
+        Smooths the positions with a rolling (coordinate-wise) median.
+        """
+        from ..processing import TemporalSmoother
+        return TemporalSmoother.median(self, window)
+
+    def clean_outliers(self: Self, max_speed: float, max_acceleration: Optional[float] = None, repair: bool = False,
+                       split: bool = False, max_gap: Optional[timedelta] = None,
+                       max_consecutive: Optional[int] = None) -> Optional[TPoint]:
+        """
+        Removes (or, with ``repair``, interpolates) the instants that can only be reached exceeding ``max_speed``
+        or ``max_acceleration``. See :class:`TrajectoryCleaner` for the details and for the report of the changes.
+        """
+        from ..processing import TrajectoryCleaner
+        return TrajectoryCleaner.clean(self, max_speed, max_acceleration, repair, split, max_gap,
+                                       max_consecutive).trajectory
+
+    def nearest_feature(self, features: Union[NearestFeatureIndex, List[Union[pg.Geometry, shpb.BaseGeometry]]],
+                        tolerance: timedelta = timedelta(seconds=1)) -> Tuple[TInt, TFloat]:
+        """
+        Index of the nearest of ``features`` at every moment, as a step temporal integer, and the distance to it.
+        Build a :class:`NearestFeatureIndex` once to reuse it across temporal points.
+        """
+        from ..processing import NearestFeatureIndex
+        index = features if isinstance(features, NearestFeatureIndex) else NearestFeatureIndex(features)
+        return index.assign(self, tolerance)
+
+    def to_cells(self, grid: CellGrid) -> Union[TInt, TText]:
+        """
+        Step temporal value with the id of the cell of ``grid`` containing the point at every moment, changing at
+        the exact instants where the point crosses the cell boundaries.
+        """
+        return grid.encode(self)
+
     def length(self) -> float:
         return tpoint_length(self._inner)
 
@@ -116,6 +182,29 @@ class TPoint(Temporal[shp.Point, TG, TI, TS, TSS], ABC):
         result, count = tpoint_stboxes(self._inner)
         return [STBox(_inner=result + i) for i in range(count)]
 
+    def split_stboxes(self, max_boxes: int, method: str = 'merge') -> List[STBox]:
+        """
+        At most ``max_boxes`` boxes covering the temporal point, grouping consecutive segments so that the boxes
+        are good index keys. See :class:`MultiBox` for the methods.
+        """
+        from ..processing import MultiBox
+        return MultiBox.split(self, max_boxes, method)
+
+    def to_geo_measure(self, measure: Union[str, TFloat] = 'time', segmentize: bool = False) -> shpb.BaseGeometry:
+        """
+        Trajectory with measures (e.g. a LineStringM) where the M value is ``measure``: ``'time'`` for the Unix
+        epoch seconds of every instant, ``'speed'``, or a temporal float. See :class:`GeoMeasure`.
+        """
+        from ..processing import GeoMeasure
+        return GeoMeasure.geometry(self, measure, segmentize)
+
+    def as_geo_measure_wkb(self, measure: Union[str, TFloat] = 'time', segmentize: bool = False) -> bytes:
+        """
+        EWKB of :meth:`to_geo_measure`, as produced by MEOS.
+        """
+        from ..processing import GeoMeasure
+        return GeoMeasure.wkb(self, measure, segmentize)
+
     def is_simple(self) -> bool:
         return tpoint_is_simple(self._inner)
 
@@ -399,6 +488,7 @@ class TPoint(Temporal[shp.Point, TG, TI, TS, TSS], ABC):
             return super().minus(other)
         return Temporal._factory(result)
 
+    @cached_operation('within_distance')
     def within_distance(self, other: Union[pg.Geometry, shpb.BaseGeometry, TPoint], distance: float) -> TBool:
         if isinstance(other, pg.Geometry) or isinstance(other, shpb.BaseGeometry):
             gs = geometry_to_gserialized(other)
@@ -477,6 +567,7 @@ class TPoint(Temporal[shp.Point, TG, TI, TS, TSS], ABC):
             raise TypeError(f'Operation not supported with type {other.__class__}')
         return Temporal._factory(result)
 
+    @cached_operation('nearest_approach_distance')
     def nearest_approach_distance(self, other: Union[pg.Geometry, STBox, TPoint]) -> float:
         from ..boxes import STBox
         if isinstance(other, pg.Geometry):
@@ -574,15 +665,18 @@ class TPointInst(TInstant[shpb.BaseGeometry, TG, TI, TS, TSS], TPoint[TG, TI, TS
 class TPointSeq(TSequence[shpb.BaseGeometry, TG, TI, TS, TSS], TPoint[TG, TI, TS, TSS], ABC):
 
     @staticmethod
-    def from_arrays(t: List[Union[datetime, str]], x: List[float], y: List[float], z: Optional[List[float]] = None,
+    def from_arrays(t: Union[List[Union[datetime, str]], np.ndarray], x: Union[List[float], np.ndarray],
+                    y: Union[List[float], np.ndarray], z: Optional[Union[List[float], np.ndarray]] = None,
                     srid: int = 0, geodetic: bool = False, lower_inc: bool = True, upper_inc: bool = False,
                     interpolation: TInterpolation = TInterpolation.LINEAR, normalize: bool = True) -> TPointSeq:
+        from ..arrays import to_timestamptz_list
         from ..factory import _TemporalFactory
         assert len(t) == len(x) == len(y)
-        times = [datetime_to_timestamptz(ti) if isinstance(ti, datetime) else pg_timestamptz_in(ti, -1) for ti in t]
+        times = to_timestamptz_list(t)
         return _TemporalFactory.create_temporal(
-            tpointseq_make_coords(x, y, z, times, len(t), srid, geodetic, lower_inc, upper_inc, interpolation,
-                                  normalize)
+            tpointseq_make_coords(np.asarray(x, dtype=float).tolist(), np.asarray(y, dtype=float).tolist(),
+                                  np.asarray(z, dtype=float).tolist() if z is not None else None,
+                                  times, len(t), srid, geodetic, lower_inc, upper_inc, interpolation, normalize)
         )
 
     def plot(self, *args, **kwargs):
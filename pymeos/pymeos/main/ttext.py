@@ -28,6 +28,7 @@ from __future__ import annotations
 from abc import ABC
 from typing import Optional, Union, List, Set
 
+import numpy as np
 from pymeos_cffi import *
 
 from ..temporal import TInterpolation, Temporal, TInstant, TSequence, TSequenceSet
@@ -263,6 +264,17 @@ class TTextSeq(TSequence[str, 'TText', 'TTextInst', 'TTextSeq', 'TTextSeqSet'],
         super().__init__(string=string, instant_list=instant_list, lower_inc=lower_inc, upper_inc=upper_inc,
                          expandable=expandable, interpolation=interpolation, normalize=normalize, _inner=_inner)
 
+    @staticmethod
+    def from_arrays(t: Union[List[Union[datetime, str]], np.ndarray], values: Union[List[str], np.ndarray],
+                    lower_inc: bool = True, upper_inc: bool = False,
+                    interpolation: TInterpolation = TInterpolation.STEPWISE, normalize: bool = True) -> TTextSeq:
+        from ..arrays import to_timestamptz_list
+        assert len(t) == len(values)
+        times = to_timestamptz_list(t)
+        instants = [ttextinst_make(str(v), ti) for v, ti in zip(values, times)]
+        return TTextSeq(_inner=tsequence_make(instants, len(instants), lower_inc, upper_inc, interpolation,
+                                              normalize))
+
 
 class TTextSeqSet(TSequenceSet[str, 'TText', 'TTextInst', 'TTextSeq', 'TTextSeqSet'], TText):
     ComponentClass = TTextSeq
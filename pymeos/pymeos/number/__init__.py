@@ -0,0 +1,6 @@
+from .floatspan import FloatSpan
+from .intspan import IntSpan
+from .span import Span
+from .spanset import SpanSet, IntSpanSet, FloatSpanSet
+
+__all__ = ['Span', 'IntSpan', 'FloatSpan', 'SpanSet', 'IntSpanSet', 'FloatSpanSet']
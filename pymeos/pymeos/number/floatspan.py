@@ -0,0 +1,85 @@
+from __future__ import annotations
+
+from typing import Union, TYPE_CHECKING
+
+import numpy as np
+from pymeos_cffi import *
+
+from .span import Span
+
+if TYPE_CHECKING:
+    from ..main import TNumber
+
+
+class FloatSpan(Span):
+    """
+    Span of floats, backed by a MEOS ``Span``.
+
+        >>> FloatSpan('[1.5, 2.5)')
+        >>> FloatSpan(lower=1.5, upper=2.5, upper_inc=True)
+    """
+    __slots__ = ['_inner']
+
+    BaseClass = float
+    _dtype = np.float64
+    _make_function = floatspan_make
+    _parse_function = floatspan_in
+
+    @staticmethod
+    def from_floatrange(value) -> FloatSpan:
+        """
+        Converts a ``spans.floatrange``.
+        """
+        return FloatSpan(_inner=floatrange_to_floatspan(value))
+
+    def to_floatrange(self):
+        """
+        Converts to a ``spans.floatrange``.
+        """
+        return floatspan_to_floatrange(self._inner)
+
+    @property
+    def lower(self) -> float:
+        return floatspan_lower(self._inner)
+
+    @property
+    def upper(self) -> float:
+        return floatspan_upper(self._inner)
+
+    def is_adjacent(self, other: Union[int, float, Span, TNumber]) -> bool:
+        if isinstance(other, (int, float)):
+            return adjacent_floatspan_float(self._inner, float(other))
+        return super().is_adjacent(other)
+
+    def contains(self, content: Union[int, float, Span, TNumber]) -> bool:
+        if isinstance(content, (int, float)):
+            return contains_floatspan_float(self._inner, float(content))
+        return super().contains(content)
+
+    def is_left(self, other: Union[int, float, Span, TNumber]) -> bool:
+        if isinstance(other, (int, float)):
+            return left_floatspan_float(self._inner, float(other))
+        return super().is_left(other)
+
+    def is_over_or_left(self, other: Union[int, float, Span, TNumber]) -> bool:
+        if isinstance(other, (int, float)):
+            return overleft_floatspan_float(self._inner, float(other))
+        return super().is_over_or_left(other)
+
+    def is_right(self, other: Union[int, float, Span, TNumber]) -> bool:
+        if isinstance(other, (int, float)):
+            return right_floatspan_float(self._inner, float(other))
+        return super().is_right(other)
+
+    def is_over_or_right(self, other: Union[int, float, Span, TNumber]) -> bool:
+        if isinstance(other, (int, float)):
+            return overright_floatspan_float(self._inner, float(other))
+        return super().is_over_or_right(other)
+
+    def distance(self, other: Union[int, float, Span]) -> float:
+        if isinstance(other, (int, float)):
+            return distance_floatspan_float(self._inner, float(other))
+        return super().distance(other)
+
+    def __str__(self):
+        return floatspan_out(self._inner, 15)
@@ -0,0 +1,86 @@
+from __future__ import annotations
+
+from typing import Union, TYPE_CHECKING
+
+import numpy as np
+from pymeos_cffi import *
+
+from .span import Span
+
+if TYPE_CHECKING:
+    from ..main import TNumber
+
+
+class IntSpan(Span):
+    """
+    Span of integers, backed by a MEOS ``Span``. Integer spans are canonicalized with an inclusive lower bound
+    and an exclusive upper bound.
+
+        >>> IntSpan('[1, 5]')
+        >>> IntSpan(lower=1, upper=5, upper_inc=True)
+    """
+    __slots__ = ['_inner']
+
+    BaseClass = int
+    _dtype = np.int64
+    _make_function = intspan_make
+    _parse_function = intspan_in
+
+    @staticmethod
+    def from_intrange(value) -> IntSpan:
+        """
+        Converts a ``spans.intrange``.
+        """
+        return IntSpan(_inner=intrange_to_intspan(value))
+
+    def to_intrange(self):
+        """
+        Converts to a ``spans.intrange``.
+        """
+        return intspan_to_intrange(self._inner)
+
+    @property
+    def lower(self) -> int:
+        return intspan_lower(self._inner)
+
+    @property
+    def upper(self) -> int:
+        return intspan_upper(self._inner)
+
+    def is_adjacent(self, other: Union[int, Span, TNumber]) -> bool:
+        if isinstance(other, int):
+            return adjacent_intspan_int(self._inner, other)
+        return super().is_adjacent(other)
+
+    def contains(self, content: Union[int, Span, TNumber]) -> bool:
+        if isinstance(content, int):
+            return contains_intspan_int(self._inner, content)
+        return super().contains(content)
+
+    def is_left(self, other: Union[int, Span, TNumber]) -> bool:
+        if isinstance(other, int):
+            return left_intspan_int(self._inner, other)
+        return super().is_left(other)
+
+    def is_over_or_left(self, other: Union[int, Span, TNumber]) -> bool:
+        if isinstance(other, int):
+            return overleft_intspan_int(self._inner, other)
+        return super().is_over_or_left(other)
+
+    def is_right(self, other: Union[int, Span, TNumber]) -> bool:
+        if isinstance(other, int):
+            return right_intspan_int(self._inner, other)
+        return super().is_right(other)
+
+    def is_over_or_right(self, other: Union[int, Span, TNumber]) -> bool:
+        if isinstance(other, int):
+            return overright_intspan_int(self._inner, other)
+        return super().is_over_or_right(other)
+
+    def distance(self, other: Union[int, Span]) -> float:
+        if isinstance(other, int):
+            return distance_intspan_int(self._inner, other)
+        return super().distance(other)
+
+    def __str__(self):
+        return intspan_out(self._inner)
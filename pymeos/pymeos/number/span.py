@@ -0,0 +1,273 @@
+from __future__ import annotations
+
+from abc import ABC, abstractmethod
+from typing import List, Optional, Sequence, TYPE_CHECKING, TypeVar, Type, Union
+
+import numpy as np
+from pymeos_cffi import *
+
+if TYPE_CHECKING:
+    from ..boxes import TBox
+    from ..main import TNumber
+
+Self = TypeVar('Self', bound='Span')
+
+
+class Span(ABC):
+    """
+    Base class for spans of numbers, backed by a MEOS ``Span``. The ``_inner`` pointer is passed as is to the MEOS
+    functions, without any conversion.
+
+    ``Span`` objects can be created with a single argument of type string as in MobilityDB, or with the bounds:
+
+        >>> FloatSpan('[1.5, 2.5)')
+        >>> FloatSpan(lower=1.5, upper=2.5, lower_inc=True, upper_inc=False)
+    """
+    __slots__ = ['_inner']
+
+    BaseClass = None
+    _dtype = None
+    _make_function = None
+    _parse_function = None
+
+    def __init__(self, string: Optional[str] = None, *, lower: Optional[Union[int, float]] = None,
+                 upper: Optional[Union[int, float]] = None, lower_inc: bool = True, upper_inc: bool = False,
+                 _inner=None):
+        assert (_inner is not None) or ((string is not None) != (lower is not None and upper is not None)), \
+            "Either string must be not None or both lower and upper must be not"
+        if _inner is not None:
+            self._inner = _inner
+        elif string is not None:
+            self._inner = self.__class__._parse_function(string)
+        else:
+            self._inner = self.__class__._make_function(self.BaseClass(lower), self.BaseClass(upper), lower_inc,
+                                                        upper_inc)
+
+    @classmethod
+    def from_arrays(cls: Type[Self], lower: Union[Sequence, np.ndarray], upper: Union[Sequence, np.ndarray],
+                    lower_inc: bool = True, upper_inc: bool = False) -> List[Self]:
+        """
+        Creates one span per pair of bounds given as sequences or numpy arrays.
+        """
+        lower = np.asarray(lower, dtype=cls._dtype)
+        upper = np.asarray(upper, dtype=cls._dtype)
+        if lower.shape != upper.shape:
+            raise ValueError(f'The bound arrays have different shapes: {lower.shape} and {upper.shape}')
+        make = cls._make_function
+        return [cls(_inner=make(lo, up, lower_inc, upper_inc)) for lo, up in zip(lower.tolist(), upper.tolist())]
+
+    @classmethod
+    def from_hexwkb(cls: Type[Self], hexwkb: str) -> Self:
+        return cls(_inner=span_from_hexwkb(hexwkb))
+
+    def as_hexwkb(self) -> str:
+        return span_as_hexwkb(self._inner, -1)[0]
+
+    @property
+    @abstractmethod
+    def lower(self) -> Union[int, float]:
+        """
+        Lower bound
+        """
+        raise NotImplementedError()
+
+    @property
+    @abstractmethod
+    def upper(self) -> Union[int, float]:
+        """
+        Upper bound
+        """
+        raise NotImplementedError()
+
+    @property
+    def lower_inc(self) -> bool:
+        """
+        Is the lower bound inclusive?
+        """
+        return self._inner.lower_inc
+
+    @property
+    def upper_inc(self) -> bool:
+        """
+        Is the upper bound inclusive?
+        """
+        return self._inner.upper_inc
+
+    @property
+    def width(self) -> float:
+        return span_width(self._inner)
+
+    def expand(self: Self, other: Self) -> Self:
+        copy = span_copy(self._inner)
+        span_expand(other._inner, copy)
+        return self.__class__(_inner=copy)
+
+    def to_tbox(self) -> TBox:
+        from ..boxes import TBox
+        return TBox(_inner=span_to_tbox(self._inner))
+
+    def is_adjacent(self, other: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(other, Span):
+            return adjacent_span_span(self._inner, other._inner)
+        elif isinstance(other, TNumber):
+            return adjacent_span_tnumber(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def is_contained_in(self, container: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(container, Span):
+            return contained_span_span(self._inner, container._inner)
+        elif isinstance(container, TNumber):
+            return contained_span_tnumber(self._inner, container._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {container.__class__}')
+
+    def contains(self, content: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(content, Span):
+            return contains_span_span(self._inner, content._inner)
+        elif isinstance(content, TNumber):
+            return contains_span_tnumber(self._inner, content._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {content.__class__}')
+
+    def overlaps(self, other: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(other, Span):
+            return overlaps_span_span(self._inner, other._inner)
+        elif isinstance(other, TNumber):
+            return overlaps_span_tnumber(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def is_left(self, other: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(other, Span):
+            return left_span_span(self._inner, other._inner)
+        elif isinstance(other, TNumber):
+            return left_span_tnumber(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def is_over_or_left(self, other: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(other, Span):
+            return overleft_span_span(self._inner, other._inner)
+        elif isinstance(other, TNumber):
+            return overleft_span_tnumber(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def is_right(self, other: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(other, Span):
+            return right_span_span(self._inner, other._inner)
+        elif isinstance(other, TNumber):
+            return right_span_tnumber(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def is_over_or_right(self, other: Union[Span, TNumber]) -> bool:
+        from ..main import TNumber
+        if isinstance(other, Span):
+            return overright_span_span(self._inner, other._inner)
+        elif isinstance(other, TNumber):
+            return overright_span_tnumber(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def distance(self, other: Span) -> float:
+        if isinstance(other, Span):
+            return distance_span_span(self._inner, other._inner)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def intersection(self: Self, other: Self) -> Optional[Self]:
+        if isinstance(other, Span):
+            result = intersection_span_span(self._inner, other._inner)
+            return self.__class__(_inner=result) if result is not None else None
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def union(self: Self, other: Self, strict: bool = True) -> Self:
+        """
+        Union of two spans. With ``strict``, they must overlap or be adjacent, otherwise the span covering both
+        is returned.
+        """
+        if isinstance(other, Span):
+            return self.__class__(_inner=union_span_span(self._inner, other._inner, strict))
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def minus(self: Self, other: Self) -> Optional[Self]:
+        if isinstance(other, Span):
+            result = minus_span_span(self._inner, other._inner)
+            return self.__class__(_inner=result) if result is not None else None
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def __mul__(self, other):
+        return self.intersection(other)
+
+    def __add__(self, other):
+        return self.union(other)
+
+    def __sub__(self, other):
+        return self.minus(other)
+
+    def __contains__(self, item):
+        return self.contains(item)
+
+    def __eq__(self, other):
+        if isinstance(other, self.__class__):
+            return span_eq(self._inner, other._inner)
+        return False
+
+    def __ne__(self, other):
+        if isinstance(other, self.__class__):
+            return span_ne(self._inner, other._inner)
+        return True
+
+    def __cmp__(self, other):
+        if isinstance(other, self.__class__):
+            return span_cmp(self._inner, other._inner)
+        raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def __lt__(self, other):
+        if isinstance(other, self.__class__):
+            return span_lt(self._inner, other._inner)
+        raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def __le__(self, other):
+        if isinstance(other, self.__class__):
+            return span_le(self._inner, other._inner)
+        raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def __gt__(self, other):
+        if isinstance(other, self.__class__):
+            return span_gt(self._inner, other._inner)
+        raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def __ge__(self, other):
+        if isinstance(other, self.__class__):
+            return span_ge(self._inner, other._inner)
+        raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    @classmethod
+    def read_from_cursor(cls, value, _=None):
+        if not value:
+            return None
+        return cls(string=value)
+
+    def __copy__(self):
+        inner_copy = span_copy(self._inner)
+        return self.__class__(_inner=inner_copy)
+
+    def __hash__(self) -> int:
+        return span_hash(self._inner)
+
+    def __repr__(self):
+        return (f'{self.__class__.__name__}'
+                f'({self})')
@@ -0,0 +1,187 @@
+from __future__ import annotations
+
+from functools import cmp_to_key
+from typing import Iterable, List, Optional, Sequence, Tuple, Type, TypeVar, Union
+
+import numpy as np
+from pymeos_cffi import *
+
+from .floatspan import FloatSpan
+from .intspan import IntSpan
+from .span import Span
+
+Self = TypeVar('Self', bound='SpanSet')
+
+
+class SpanSet:
+    """
+    Ordered set of disjoint spans of numbers.
+
+    MEOS exposes no span set type in this version, so the set is kept as a list of MEOS ``Span`` pointers that is
+    passed directly to the functions taking an array of spans, such as ``tnumber_at_spans``. Unless
+    ``normalize`` is ``False``, the spans are sorted and the overlapping or adjacent ones are merged.
+
+        >>> FloatSpanSet(['[1, 2)', '[3, 4]'])
+        >>> FloatSpanSet.from_arrays(np.array([1, 3]), np.array([2, 4]))
+    """
+    __slots__ = ['_spans', '_inners']
+
+    SpanClass: Type[Span] = None
+
+    def __init__(self, span_list: Iterable[Union[str, Span]] = (), normalize: bool = True):
+        spans = [s if isinstance(s, Span) else self.SpanClass(string=s) for s in span_list]
+        for s in spans:
+            if not isinstance(s, self.SpanClass):
+                raise TypeError(f'Operation not supported with type {s.__class__}')
+        self._spans = SpanSet._normalize(spans) if normalize else spans
+        self._inners = [s._inner for s in self._spans]
+
+    @classmethod
+    def from_arrays(cls: Type[Self], lower: Union[Sequence, np.ndarray], upper: Union[Sequence, np.ndarray],
+                    lower_inc: bool = True, upper_inc: bool = False, normalize: bool = True) -> Self:
+        """
+        Creates a span set from arrays of lower and upper bounds.
+        """
+        return cls(cls.SpanClass.from_arrays(lower, upper, lower_inc, upper_inc), normalize)
+
+    @staticmethod
+    def _normalize(spans: List[Span]) -> List[Span]:
+        if len(spans) < 2:
+            return list(spans)
+        spans = sorted(spans, key=cmp_to_key(lambda a, b: span_cmp(a._inner, b._inner)))
+        result = [spans[0]]
+        for s in spans[1:]:
+            last = result[-1]
+            if overlaps_span_span(last._inner, s._inner) or adjacent_span_span(last._inner, s._inner):
+                result[-1] = last.union(s, strict=False)
+            else:
+                result.append(s)
+        return result
+
+    def _bound_spans(self) -> Tuple[Span, Span]:
+        if not self._spans:
+            raise ValueError('The span set is empty')
+        return self._spans[0], self._spans[-1]
+
+    @property
+    def spans(self) -> List[Span]:
+        return list(self._spans)
+
+    @property
+    def num_spans(self) -> int:
+        return len(self._spans)
+
+    def span_n(self, n: int) -> Span:
+        return self._spans[n]
+
+    @property
+    def start_span(self) -> Span:
+        return self._bound_spans()[0]
+
+    @property
+    def end_span(self) -> Span:
+        return self._bound_spans()[1]
+
+    @property
+    def span(self) -> Span:
+        """
+        Span covering all the spans of the set
+        """
+        start, end = self._bound_spans()
+        return start.union(end, strict=False)
+
+    @property
+    def lower(self) -> Union[int, float]:
+        return self._bound_spans()[0].lower
+
+    @property
+    def upper(self) -> Union[int, float]:
+        return self._bound_spans()[1].upper
+
+    @property
+    def width(self) -> float:
+        """
+        Sum of the widths of the spans
+        """
+        return sum(span_width(i) for i in self._inners)
+
+    def bounds(self) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Lower and upper bounds of the spans as numpy arrays.
+        """
+        dtype = self.SpanClass._dtype
+        return np.array([s.lower for s in self._spans], dtype=dtype), \
+            np.array([s.upper for s in self._spans], dtype=dtype)
+
+    def contains(self, content: Union[int, float, Span, SpanSet]) -> bool:
+        if isinstance(content, SpanSet):
+            return all(self.contains(s) for s in content._spans)
+        return any(s.contains(content) for s in self._spans)
+
+    def overlaps(self, other: Union[Span, SpanSet]) -> bool:
+        if isinstance(other, SpanSet):
+            return any(self.overlaps(s) for s in other._spans)
+        elif isinstance(other, Span):
+            return any(overlaps_span_span(i, other._inner) for i in self._inners)
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def union(self: Self, other: Union[Span, SpanSet]) -> Self:
+        if isinstance(other, SpanSet):
+            return self.__class__(self._spans + other._spans)
+        elif isinstance(other, Span):
+            return self.__class__(self._spans + [other])
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+
+    def intersection(self: Self, other: Union[Span, SpanSet]) -> Self:
+        others = other._spans if isinstance(other, SpanSet) else [other]
+        result = [s.intersection(o) for s in self._spans for o in others if s.overlaps(o)]
+        return self.__class__([r for r in result if r is not None])
+
+    def __add__(self, other):
+        return self.union(other)
+
+    def __mul__(self, other):
+        return self.intersection(other)
+
+    def __contains__(self, item):
+        return self.contains(item)
+
+    def __iter__(self):
+        return iter(self._spans)
+
+    def __len__(self):
+        return len(self._spans)
+
+    def __eq__(self, other):
+        if isinstance(other, self.__class__):
+            return len(self._inners) == len(other._inners) and \
+                all(span_eq(a, b) for a, b in zip(self._inners, other._inners))
+        return False
+
+    def __hash__(self) -> int:
+        return hash(tuple(span_hash(i) for i in self._inners))
+
+    def __str__(self):
+        return '{' + ', '.join(str(s) for s in self._spans) + '}'
+
+    def __repr__(self):
+        return (f'{self.__class__.__name__}'
+                f'({self})')
+
+
+class IntSpanSet(SpanSet):
+    """
+    Ordered set of disjoint spans of integers.
+    """
+    __slots__ = []
+    SpanClass = IntSpan
+
+
+class FloatSpanSet(SpanSet):
+    """
+    Ordered set of disjoint spans of floats.
+    """
+    __slots__ = []
+    SpanClass = FloatSpan
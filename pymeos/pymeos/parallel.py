@@ -0,0 +1,20 @@
+from concurrent.futures import ThreadPoolExecutor
+from typing import Callable, Iterable, List, Optional, TypeVar
+
+T = TypeVar('T')
+R = TypeVar('R')
+
+
+def parallel_map(function: Callable[[T], R], items: Iterable[T], max_workers: Optional[int] = None) -> List[R]:
+    """
+    Applies ``function`` to every item on a thread pool and returns the results in the input order.
+
+    CFFI releases the GIL only for the duration of each MEOS call, so only those calls run concurrently: the
+    Python code of ``function`` still holds the GIL, and functions that mostly loop in Python do not speed up.
+    With ``max_workers=1`` the items are processed in the calling thread.
+    """
+    items = list(items)
+    if max_workers == 1 or len(items) <= 1:
+        return [function(item) for item in items]
+    with ThreadPoolExecutor(max_workers=max_workers) as executor:
+        return list(executor.map(function, items))
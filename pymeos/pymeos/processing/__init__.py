@@ -0,0 +1,51 @@
+from .cleaning import TrajectoryCleaner, CleaningResult
+from .smoothing import TemporalSmoother
+from .snapshot import SnapshotIndex, Snapshot, SnapshotFrames
+from .nearest import NearestFeatureIndex
+from .od import OriginDestination, ODMatrix
+from .grid import CellGrid, QuadGrid, GeohashGrid
+from .multibox import MultiBox
+from .measure import GeoMeasure
+from .trips import TripsExport, TripBuffers
+from .stream import ContinuousQueryEngine, StreamEvent
+from .profile import QualityProfiler, QualityProfile
+from .serialize import BulkSerializer
+from .appendable import AppendableTrajectory, AppendableTFloat
+from .upsert import BatchUpsert
+from .periods import PeriodSweep, PeriodBounds
+from .synthetic import TrajectoryGenerator, SyntheticPoints
+from .similarity import TrajectorySimilarityIndex
+from .multiattribute import MultiAttributeTrajectory
+
+__all__ = [
+    'TemporalSmoother',
+    'TrajectoryCleaner',
+    'CleaningResult',
+    'SnapshotIndex',
+    'Snapshot',
+    'SnapshotFrames',
+    'NearestFeatureIndex',
+    'OriginDestination',
+    'ODMatrix',
+    'CellGrid',
+    'QuadGrid',
+    'GeohashGrid',
+    'MultiBox',
+    'GeoMeasure',
+    'TripsExport',
+    'TripBuffers',
+    'ContinuousQueryEngine',
+    'StreamEvent',
+    'QualityProfiler',
+    'QualityProfile',
+    'BulkSerializer',
+    'AppendableTrajectory',
+    'AppendableTFloat',
+    'BatchUpsert',
+    'PeriodSweep',
+    'PeriodBounds',
+    'TrajectoryGenerator',
+    'SyntheticPoints',
+    'TrajectorySimilarityIndex',
+    'MultiAttributeTrajectory',
+]
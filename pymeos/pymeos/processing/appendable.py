@@ -0,0 +1,224 @@
+from __future__ import annotations
+
+import math
+from abc import ABC, abstractmethod
+from datetime import datetime, timedelta
+from typing import Dict, Optional, Union
+
+from pymeos_cffi import temporal_append_tinstant, tsequence_make_exp, temporal_copy, temporal_start_instant, \
+    tpointseq_make_coords, tfloatinst_make, tpoint_length, tpoint_speed, tpoint_to_stbox, tfloat_end_value, \
+    tfloat_min_value, tfloat_max_value, tnumber_integral, tnumber_twavg, stbox_make, period_make, stbox_xmin, \
+    stbox_xmax, stbox_ymin, stbox_ymax, stbox_zmin, stbox_zmax, temporal_num_instants, timestamptz_to_datetime
+
+from ..arrays import to_timestamptz_list
+from ..boxes import STBox
+from ..temporal import Temporal, TInterpolation
+
+
+class _AppendableSequence(ABC):
+    """
+    Expandable MEOS sequence with summary metrics updated on every appended instant.
+    """
+
+    def __init__(self, interpolation: TInterpolation, capacity: int):
+        if capacity < 1:
+            raise ValueError(f'The capacity must be positive, got {capacity}')
+        self.interpolation = interpolation
+        self._capacity = capacity
+        self._inner = None
+        self._start: Optional[int] = None
+        self._end: Optional[int] = None
+        self.appended = 0
+
+    def _append_instant(self, instant, t: int) -> None:
+        if self._inner is None:
+            self._inner = tsequence_make_exp([instant], 1, self._capacity, True, True, self.interpolation, True)
+            self._start = t
+        else:
+            # MEOS reallocates the sequence with a larger capacity when it is full
+            self._inner = temporal_append_tinstant(self._inner, instant, True)
+        self._end = t
+        self.appended += 1
+
+    def _timestamp(self, t: Union[datetime, str, int]) -> int:
+        t = to_timestamptz_list([t])[0]
+        if self._end is not None and t <= self._end:
+            raise ValueError('Instants must be appended in increasing temporal order')
+        return t
+
+    def __len__(self):
+        return 0 if self._inner is None else temporal_num_instants(self._inner)
+
+    @property
+    def start_timestamp(self) -> Optional[datetime]:
+        return None if self._start is None else timestamptz_to_datetime(self._start)
+
+    @property
+    def end_timestamp(self) -> Optional[datetime]:
+        return None if self._end is None else timestamptz_to_datetime(self._end)
+
+    @property
+    def duration(self) -> timedelta:
+        return timedelta(microseconds=0 if self._start is None else self._end - self._start)
+
+    @property
+    def sequence(self) -> Optional[Temporal]:
+        """
+        Copy of the sequence appended so far, ``None`` before the first instant.
+        """
+        return None if self._inner is None else Temporal._factory(temporal_copy(self._inner))
+
+    def verify(self, rel_tol: float = 1e-9, abs_tol: float = 1e-9) -> None:
+        """
+        Recomputes the metrics from the whole sequence with MEOS and raises a ``ValueError`` listing the metrics
+        whose incremental value differs.
+        """
+        if self._inner is None:
+            return
+        mismatches = [f'{name}: incremental {value}, recomputed {expected}'
+                      for name, (value, expected) in self._compare().items()
+                      if not (value is None and expected is None) and
+                      (value is None or expected is None or
+                       not math.isclose(value, expected, rel_tol=rel_tol, abs_tol=abs_tol))]
+        if mismatches:
+            raise ValueError('Inconsistent incremental metrics: ' + '; '.join(mismatches))
+
+    @abstractmethod
+    def _compare(self) -> Dict[str, tuple]:
+        # Incremental and recomputed value of every metric
+        pass
+
+
+class AppendableTrajectory(_AppendableSequence):
+    """
+    Temporal geometric point built by appending positions, maintaining its length, bounding box and speed in
+    constant time per position instead of rescanning the sequence.
+
+        >>> trajectory = AppendableTrajectory(srid=3857)
+        >>> trajectory.append('2023-01-01 08:00:00+00', 0, 0)
+        >>> trajectory.append('2023-01-01 08:00:10+00', 30, 40)
+        >>> trajectory.length, trajectory.speed
+        (50.0, 5.0)
+    """
+
+    def __init__(self, srid: int = 0, hasz: bool = False, interpolation: TInterpolation = TInterpolation.LINEAR,
+                 capacity: int = 64):
+        if interpolation not in (TInterpolation.LINEAR, TInterpolation.STEPWISE):
+            raise ValueError(f'Unsupported interpolation {interpolation}')
+        super().__init__(interpolation, capacity)
+        self.srid = srid
+        self.hasz = hasz
+        self.length = 0.0
+        self.speed: Optional[float] = None
+        self.max_speed: Optional[float] = None
+        self._last: Optional[tuple] = None
+        self._min: Optional[list] = None
+        self._max: Optional[list] = None
+
+    def append(self, t: Union[datetime, str, int], x: float, y: float, z: Optional[float] = None) -> None:
+        """
+        Appends the position at ``t``, which must be after the last appended instant.
+        """
+        if (z is not None) != self.hasz:
+            raise ValueError('The Z coordinate must be given if and only if the trajectory has Z')
+        ts = self._timestamp(t)
+        position = (float(x), float(y)) if z is None else (float(x), float(y), float(z))
+        single = tpointseq_make_coords([position[0]], [position[1]], [position[2]] if self.hasz else None, [ts], 1,
+                                       self.srid, False, True, True, self.interpolation, False)
+        previous, end = self._last, self._end
+        self._append_instant(temporal_start_instant(single), ts)
+        if previous is None:
+            self._min, self._max = list(position), list(position)
+        else:
+            # With step interpolation the point jumps at the end of the interval, so it does not travel
+            step = 0.0 if self.interpolation == TInterpolation.STEPWISE else \
+                math.sqrt(sum((b - a) ** 2 for a, b in zip(previous, position)))
+            self.length += step
+            self.speed = step / ((ts - end) / 1e6)
+            self.max_speed = self.speed if self.max_speed is None else max(self.max_speed, self.speed)
+            self._min = [min(a, b) for a, b in zip(self._min, position)]
+            self._max = [max(a, b) for a, b in zip(self._max, position)]
+        self._last = position
+
+    @property
+    def average_speed(self) -> Optional[float]:
+        seconds = self.duration.total_seconds()
+        return self.length / seconds if seconds > 0 else None
+
+    @property
+    def stbox(self) -> Optional[STBox]:
+        """
+        Bounding box of the positions appended so far.
+        """
+        if self._inner is None:
+            return None
+        zmin, zmax = (self._min[2], self._max[2]) if self.hasz else (0.0, 0.0)
+        return STBox(_inner=stbox_make(period_make(self._start, self._end, True, True), True, self.hasz, False,
+                                       self.srid, self._min[0], self._max[0], self._min[1], self._max[1], zmin, zmax))
+
+    def _compare(self) -> Dict[str, tuple]:
+        box = tpoint_to_stbox(self._inner)
+        linear = self.interpolation == TInterpolation.LINEAR
+        speed = tpoint_speed(self._inner) if linear and len(self) > 1 else None
+        metrics = {
+            'length': (self.length, tpoint_length(self._inner)),
+            'speed': (self.speed if linear else None, None if speed is None else tfloat_end_value(speed)),
+            'xmin': (self._min[0], stbox_xmin(box)), 'xmax': (self._max[0], stbox_xmax(box)),
+            'ymin': (self._min[1], stbox_ymin(box)), 'ymax': (self._max[1], stbox_ymax(box)),
+        }
+        if self.hasz:
+            metrics.update({'zmin': (self._min[2], stbox_zmin(box)), 'zmax': (self._max[2], stbox_zmax(box))})
+        return metrics
+
+
+class AppendableTFloat(_AppendableSequence):
+    """
+    Temporal float built by appending values, maintaining its minimum, maximum, integral, time-weighted average and
+    current rate of change in constant time per value. As in MEOS, the integral is in value x microseconds.
+    """
+
+    def __init__(self, interpolation: TInterpolation = TInterpolation.LINEAR, capacity: int = 64):
+        if interpolation not in (TInterpolation.LINEAR, TInterpolation.STEPWISE):
+            raise ValueError(f'Unsupported interpolation {interpolation}')
+        super().__init__(interpolation, capacity)
+        self.min_value: Optional[float] = None
+        self.max_value: Optional[float] = None
+        self.integral = 0.0
+        self.rate: Optional[float] = None
+        self._last: Optional[float] = None
+
+    def append(self, t: Union[datetime, str, int], value: float) -> None:
+        """
+        Appends the value at ``t``, which must be after the last appended instant.
+        """
+        ts = self._timestamp(t)
+        value = float(value)
+        previous, end = self._last, self._end
+        self._append_instant(tfloatinst_make(value, ts), ts)
+        if previous is None:
+            self.min_value = self.max_value = value
+        else:
+            elapsed = ts - end
+            if self.interpolation == TInterpolation.LINEAR:
+                self.integral += (previous + value) / 2 * elapsed
+            else:
+                self.integral += previous * elapsed
+            self.rate = (value - previous) / (elapsed / 1e6)
+            self.min_value = min(self.min_value, value)
+            self.max_value = max(self.max_value, value)
+        self._last = value
+
+    @property
+    def time_weighted_average(self) -> Optional[float]:
+        if self._inner is None:
+            return None
+        elapsed = self._end - self._start
+        return self.integral / elapsed if elapsed > 0 else self._last
+
+    def _compare(self) -> Dict[str, tuple]:
+        return {
+            'min_value': (self.min_value, tfloat_min_value(self._inner)),
+            'max_value': (self.max_value, tfloat_max_value(self._inner)),
+            'integral': (self.integral, tnumber_integral(self._inner)),
+            'time_weighted_average': (self.time_weighted_average, tnumber_twavg(self._inner)),
+        }
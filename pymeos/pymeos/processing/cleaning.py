@@ -0,0 +1,176 @@
+from __future__ import annotations
+
+from dataclasses import dataclass, field
+from datetime import timedelta
+from functools import partial
+from typing import List, Optional, Tuple
+
+import numpy as np
+
+from pymeos_cffi import tsequenceset_make
+
+from .common import sequence_arrays, rebuild_sequence, haversine
+from ..main import TPoint, TGeogPoint
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant, TInterpolation
+
+
+@dataclass
+class CleaningResult:
+    """
+    Result of cleaning a trajectory.
+
+    ``trajectory`` is ``None`` when no instant survives. ``dropped`` and ``repaired`` hold the timestamps
+    (``datetime64[us]``, UTC) of the removed instants and of the instants whose position was interpolated, and
+    ``splits`` the timestamps where a new sequence was started because of an unrecoverable gap.
+    """
+    trajectory: Optional[TPoint]
+    dropped: np.ndarray = field(default_factory=lambda: np.empty(0, dtype='datetime64[us]'))
+    repaired: np.ndarray = field(default_factory=lambda: np.empty(0, dtype='datetime64[us]'))
+    splits: np.ndarray = field(default_factory=lambda: np.empty(0, dtype='datetime64[us]'))
+
+
+class TrajectoryCleaner:
+    """
+    Removes or repairs teleport jumps of temporal points.
+
+    Every sequence is scanned once: an instant is rejected when the speed (or the change of speed) needed to reach
+    it from the last accepted instant exceeds the given limits. Speeds are expressed in units of the SRID per
+    second, or in meters per second for geographic points.
+
+    When ``max_consecutive`` instants in a row are rejected, or the time elapsed since the last accepted instant
+    exceeds ``max_gap``, the gap is considered unrecoverable: the current instant is accepted as the start of a new
+    sequence when ``split`` is set, and the result becomes a sequence set. Discrete sequences are never split.
+
+    Without ``split``, ``max_consecutive`` rejected instants instead mean that the last accepted instant is wrong,
+    as when the first fix of a sequence is a glitch: the scan restarts from the first rejected instant, and the
+    previous anchor is dropped unless it was itself reached from an accepted instant.
+    """
+
+    @staticmethod
+    def clean(trajectory: TPoint, max_speed: float, max_acceleration: Optional[float] = None, repair: bool = False,
+              split: bool = False, max_gap: Optional[timedelta] = None,
+              max_consecutive: Optional[int] = None) -> CleaningResult:
+        """
+        Cleans a trajectory.
+
+        Args:
+            trajectory: temporal point to clean.
+            max_speed: maximum speed allowed between consecutive accepted instants.
+            max_acceleration: maximum change of speed per second allowed between consecutive segments.
+            repair: whether rejected instants lying between accepted ones are kept with a position linearly
+                interpolated in time instead of being dropped.
+            split: whether to start a new sequence at unrecoverable gaps.
+            max_gap: elapsed time after which a gap is unrecoverable, only used with ``split``.
+            max_consecutive: number of consecutive rejected instants after which a gap is unrecoverable with
+                ``split``, or after which the scan restarts from the first of them without it.
+        """
+        if not isinstance(trajectory, TPoint):
+            raise TypeError(f'Operation not supported with type {trajectory.__class__}')
+        if isinstance(trajectory, TInstant):
+            return CleaningResult(trajectory)
+        geodetic = isinstance(trajectory, TGeogPoint)
+        max_gap_seconds = max_gap.total_seconds() if max_gap is not None else None
+        pieces = []
+        dropped, repaired, splits = [], [], []
+        for sequence in trajectory.sequences:
+            t, coords = sequence_arrays(sequence)
+            seconds = (t - t[0]) / np.timedelta64(1, 's')
+            can_split = split and sequence.interpolation != TInterpolation.DISCRETE
+            accepted, starts = TrajectoryCleaner._scan(seconds, coords, geodetic, max_speed, max_acceleration,
+                                                       max_gap_seconds if can_split else None, max_consecutive,
+                                                       can_split)
+            bounds = list(starts) + [len(t)]
+            for start, end in zip(bounds[:-1], bounds[1:]):
+                keep = np.zeros(len(t), dtype=bool)
+                keep[start:end] = accepted[start:end]
+                rejected = np.flatnonzero(~accepted[start:end]) + start
+                if repair and rejected.size:
+                    kept = np.flatnonzero(keep)
+                    between = (rejected > kept[0]) & (rejected < kept[-1])
+                    inner = rejected[between]
+                    for d in range(coords.shape[1]):
+                        coords[inner, d] = np.interp(seconds[inner], seconds[kept], coords[kept, d])
+                    keep[inner] = True
+                    repaired.append(t[inner])
+                    rejected = rejected[~between]
+                dropped.append(t[rejected])
+                lower_inc = sequence.lower_inc if start == 0 and keep[0] else True
+                upper_inc = sequence.upper_inc if end == len(t) and keep[-1] else True
+                pieces.append(rebuild_sequence(sequence, t[keep], coords[keep], lower_inc, upper_inc))
+            splits.extend(t[s] for s in starts[1:])
+        result = TrajectoryCleaner._assemble(trajectory, pieces)
+        return CleaningResult(result,
+                              np.concatenate(dropped) if dropped else np.empty(0, dtype='datetime64[us]'),
+                              np.concatenate(repaired) if repaired else np.empty(0, dtype='datetime64[us]'),
+                              np.array(splits, dtype='datetime64[us]'))
+
+    @staticmethod
+    def batch(trajectories: List[TPoint], max_speed: float, max_workers: Optional[int] = None,
+              **kwargs) -> List[CleaningResult]:
+        """
+        Cleans every trajectory on a thread pool. Keyword arguments are passed to ``clean``.
+        """
+        return parallel_map(partial(TrajectoryCleaner.clean, max_speed=max_speed, **kwargs), trajectories,
+                            max_workers)
+
+    @staticmethod
+    def _assemble(trajectory: TPoint, pieces: list) -> Optional[TPoint]:
+        if len(pieces) == 0:
+            return None
+        if len(pieces) == 1 and pieces[0].interpolation == TInterpolation.DISCRETE:
+            return pieces[0]
+        if len(pieces) == 1 and trajectory.num_sequences == 1:
+            return pieces[0]
+        return Temporal._factory(tsequenceset_make([p._inner for p in pieces], len(pieces), False))
+
+    @staticmethod
+    def _scan(seconds: np.ndarray, coords: np.ndarray, geodetic: bool, max_speed: float,
+              max_acceleration: Optional[float], max_gap: Optional[float], max_consecutive: Optional[int],
+              split: bool) -> Tuple[np.ndarray, List[int]]:
+        n = len(seconds)
+        accepted = np.zeros(n, dtype=bool)
+        accepted[0] = True
+        starts = [0]
+        last = 0
+        last_speed = None
+        # Whether the anchor was reached from a previous accepted instant, instead of being accepted by default
+        confirmed = False
+        first_rejected = rejected_run = 0
+        i = 1
+        while i < n:
+            dt = seconds[i] - seconds[last]
+            unrecoverable = max_consecutive is not None and rejected_run >= max_consecutive
+            if split and ((max_gap is not None and dt > max_gap) or unrecoverable):
+                accepted[i] = True
+                starts.append(i)
+                last, last_speed, confirmed, rejected_run = i, None, False, 0
+                i += 1
+                continue
+            if unrecoverable:
+                # No instant could be reached from the anchor, restart from the first one rejected
+                if not confirmed:
+                    accepted[last] = False
+                last, last_speed, confirmed, rejected_run = first_rejected, None, False, 0
+                accepted[last] = True
+                i = last + 1
+                continue
+            speed = TrajectoryCleaner._distance(coords[last], coords[i], geodetic) / dt
+            ok = speed <= max_speed
+            if ok and max_acceleration is not None and last_speed is not None:
+                ok = abs(speed - last_speed) / dt <= max_acceleration
+            if ok:
+                accepted[i] = True
+                last, last_speed, confirmed, rejected_run = i, speed, True, 0
+            else:
+                if rejected_run == 0:
+                    first_rejected = i
+                rejected_run += 1
+            i += 1
+        return accepted, starts
+
+    @staticmethod
+    def _distance(p1: np.ndarray, p2: np.ndarray, geodetic: bool) -> float:
+        if not geodetic:
+            return float(np.sqrt(((p2 - p1) ** 2).sum()))
+        return float(haversine(p1[0], p1[1], p2[0], p2[1]))
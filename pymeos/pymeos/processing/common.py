@@ -0,0 +1,49 @@
+from typing import Optional, Tuple
+
+import numpy as np
+
+from ..main import TPoint, TPointSeq, TGeogPoint, TFloatSeq
+from ..temporal import TSequence
+
+# Mean radius of the Earth in meters, used for the distances between geographic points
+EARTH_RADIUS = 6371008.8
+
+
+def sequence_arrays(sequence: TSequence) -> Tuple[np.ndarray, np.ndarray]:
+    """
+    Timestamps (``datetime64[us]``) and an (n, d) array with the values of a temporal float or integer sequence
+    (d = 1) or the coordinates of a temporal point sequence (d = 2 or 3).
+    """
+    if isinstance(sequence, TPoint):
+        t, x, y, z = sequence.to_arrays()
+        return t, np.column_stack([x, y] if z is None else [x, y, z])
+    t, v = sequence.to_arrays()
+    return t, v.reshape(-1, 1)
+
+
+def rebuild_sequence(like: TSequence, t: np.ndarray, values: np.ndarray, lower_inc: Optional[bool] = None,
+                     upper_inc: Optional[bool] = None) -> TSequence:
+    """
+    Builds a sequence of the same type, SRID and interpolation as ``like`` from the arrays returned by
+    ``sequence_arrays``. Bounds default to the ones of ``like`` and are forced to inclusive for single instants.
+    """
+    lower_inc = like.lower_inc if lower_inc is None else lower_inc
+    upper_inc = like.upper_inc if upper_inc is None else upper_inc
+    if len(t) == 1:
+        lower_inc = upper_inc = True
+    if isinstance(like, TPoint):
+        return TPointSeq.from_arrays(t, values[:, 0], values[:, 1], values[:, 2] if values.shape[1] > 2 else None,
+                                     srid=like.srid, geodetic=isinstance(like, TGeogPoint), lower_inc=lower_inc,
+                                     upper_inc=upper_inc, interpolation=like.interpolation, normalize=False)
+    return TFloatSeq.from_arrays(t, values[:, 0], lower_inc=lower_inc, upper_inc=upper_inc,
+                                 interpolation=like.interpolation, normalize=False)
+
+
+def haversine(lon1: np.ndarray, lat1: np.ndarray, lon2: np.ndarray, lat2: np.ndarray) -> np.ndarray:
+    """
+    Great-circle distances in meters on a sphere between points given in degrees.
+    """
+    lon1, lat1, lon2, lat2 = map(np.radians, (lon1, lat1, lon2, lat2))
+    a = np.sin((lat2 - lat1) / 2) ** 2 + np.cos(lat1) * np.cos(lat2) * np.sin((lon2 - lon1) / 2) ** 2
+    # Rounding may take a slightly above 1 for antipodal points
+    return 2 * EARTH_RADIUS * np.arcsin(np.sqrt(np.clip(a, 0, 1)))
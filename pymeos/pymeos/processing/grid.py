@@ -0,0 +1,238 @@
+from __future__ import annotations
+
+from abc import ABC, abstractmethod
+from typing import List, Optional, Tuple, Union
+
+import numpy as np
+from pymeos_cffi import tintinst_make, ttextinst_make, tsequenceset_make
+
+from .common import sequence_arrays
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64
+from ..main import TPoint, TInt, TIntInst, TIntSeq, TText, TTextInst, TTextSeq
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant, TSequenceSet, TInterpolation
+
+_GEOHASH_ALPHABET = np.array(list('0123456789bcdefghjkmnpqrstuvwxyz'))
+
+
+class CellGrid(ABC):
+    """
+    Rectilinear grid of cells whose ids are computed from the column and row of the cell.
+
+    Temporal points are encoded as step functions of the id of the cell containing them. Along the segments of
+    linear sequences, the instants where the point enters a new cell are computed exactly by intersecting the
+    segment with the grid lines it crosses, in the coordinates of the point (longitude and latitude for geographic
+    points). Cells include their lower bounds, and when a point moves along a grid line, it is in the cell above
+    or to the right of the line.
+    """
+
+    def __init__(self, xmin: float, ymin: float, cell_width: float, cell_height: float, columns: int, rows: int):
+        self.xmin = xmin
+        self.ymin = ymin
+        self.cell_width = cell_width
+        self.cell_height = cell_height
+        self.columns = columns
+        self.rows = rows
+
+    @abstractmethod
+    def ids(self, column: np.ndarray, row: np.ndarray) -> np.ndarray:
+        """
+        Ids of the cells in the given columns and rows.
+        """
+        pass
+
+    @abstractmethod
+    def _instant(self, cell_id, timestamp: int) -> TInstant:
+        pass
+
+    @abstractmethod
+    def _sequence(self, t: np.ndarray, ids: np.ndarray, lower_inc: bool, upper_inc: bool,
+                  interpolation: TInterpolation) -> Union[TIntSeq, TTextSeq]:
+        pass
+
+    def cells(self, x: np.ndarray, y: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Columns and rows of the cells containing the given positions. Positions on the upper bounds of the
+        grid are in the last column or row.
+        """
+        column = np.floor((np.asarray(x, dtype=float) - self.xmin) / self.cell_width).astype(np.int64)
+        row = np.floor((np.asarray(y, dtype=float) - self.ymin) / self.cell_height).astype(np.int64)
+        column = np.where(column == self.columns, self.columns - 1, column)
+        row = np.where(row == self.rows, self.rows - 1, row)
+        if ((column < 0) | (column >= self.columns) | (row < 0) | (row >= self.rows)).any():
+            raise ValueError('Position outside of the extent of the grid')
+        return column, row
+
+    def encode(self, tpoint: TPoint) -> Union[TInt, TText]:
+        """
+        Step temporal value with the id of the cell containing ``tpoint`` at every moment.
+        """
+        if not isinstance(tpoint, TPoint):
+            raise TypeError(f'Operation not supported with type {tpoint.__class__}')
+        if isinstance(tpoint, TInstant):
+            t, ids = self._encode_sequence(tpoint)
+            return self._instant(ids[0], int(t[0]))
+        pieces = []
+        for sequence in tpoint.sequences:
+            t, ids = self._encode_sequence(sequence)
+            interpolation = TInterpolation.DISCRETE if sequence.interpolation == TInterpolation.DISCRETE \
+                else TInterpolation.STEPWISE
+            pieces.append(self._sequence(t, ids, sequence.lower_inc, sequence.upper_inc, interpolation))
+        if not isinstance(tpoint, TSequenceSet):
+            return pieces[0]
+        return Temporal._factory(tsequenceset_make([p._inner for p in pieces], len(pieces), True))
+
+    def encode_arrays(self, tpoint: TPoint) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Timestamps (``datetime64[us]``) where ``tpoint`` enters a cell and the ids of the cells, over all its
+        sequences. A cell appears again after a gap between sequences.
+        """
+        if not isinstance(tpoint, TPoint):
+            raise TypeError(f'Operation not supported with type {tpoint.__class__}')
+        sequences = [tpoint] if isinstance(tpoint, TInstant) else tpoint.sequences
+        encoded = [self._encode_sequence(sequence) for sequence in sequences]
+        # The last instant of a sequence closes its last cell and is not an entry
+        t = np.concatenate([t if len(t) == 1 else t[:-1] for t, _ in encoded])
+        ids = np.concatenate([ids if len(ids) == 1 else ids[:-1] for _, ids in encoded])
+        return timestamptz_array_to_datetime64(t), ids
+
+    def encode_batch(self, tpoints: List[TPoint], max_workers: Optional[int] = None) -> List[Union[TInt, TText]]:
+        """
+        Encodes every temporal point on a thread pool.
+        """
+        return parallel_map(self.encode, tpoints, max_workers)
+
+    def encode_batch_arrays(self, tpoints: List[TPoint],
+                            max_workers: Optional[int] = None) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+        """
+        Cell entries of all the temporal points for bulk indexing: the position of the temporal point in
+        ``tpoints``, the timestamp of the entry and the id of the cell.
+        """
+        encoded = parallel_map(self.encode_arrays, tpoints, max_workers)
+        if not encoded:
+            return np.empty(0, dtype=np.int64), np.empty(0, dtype='datetime64[us]'), self.ids(
+                np.empty(0, dtype=np.int64), np.empty(0, dtype=np.int64))
+        index = np.concatenate([np.full(len(t), n) for n, (t, _) in enumerate(encoded)])
+        return index, np.concatenate([t for t, _ in encoded]), np.concatenate([ids for _, ids in encoded])
+
+    def _encode_sequence(self, sequence: TPoint) -> Tuple[np.ndarray, np.ndarray]:
+        # Entry timestamps into the cells and their ids, followed by the last instant with the last cell
+        t, coords = sequence_arrays(sequence)
+        t = datetime64_to_timestamptz_array(t)
+        column, row = self.cells(coords[:, 0], coords[:, 1])
+        if sequence.interpolation != TInterpolation.LINEAR or len(t) == 1:
+            return t, self.ids(column, row)
+        times, columns, rows = [t[:1]], [column[:1]], [row[:1]]
+        for k in np.flatnonzero((column[1:] != column[:-1]) | (row[1:] != row[:-1])):
+            fractions = self._crossings(coords[k], coords[k + 1], column[k], column[k + 1], row[k], row[k + 1])
+            middle = (fractions + np.append(fractions[1:], 1.0)) / 2
+            positions = coords[k, :2] + middle[:, None] * (coords[k + 1, :2] - coords[k, :2])
+            c, r = self.cells(positions[:, 0], positions[:, 1])
+            times.append(t[k] + np.round(fractions * (t[k + 1] - t[k])).astype(np.int64))
+            columns.append(c)
+            rows.append(r)
+        times.append(t[-1:])
+        columns.append(column[-1:])
+        rows.append(row[-1:])
+        times, column, row = np.concatenate(times), np.concatenate(columns), np.concatenate(rows)
+        # Crossings closer than a microsecond collapse into the same timestamp, where the last cell wins
+        keep = np.append(times[1:] != times[:-1], True)
+        times, column, row = times[keep], column[keep], row[keep]
+        # Keep the first instant, the changes of cell and the last instant
+        keep = np.insert((column[1:] != column[:-1]) | (row[1:] != row[:-1]), 0, True)
+        keep[-1] = True
+        return times[keep], self.ids(column[keep], row[keep])
+
+    def _crossings(self, p0: np.ndarray, p1: np.ndarray, c0: int, c1: int, r0: int, r1: int) -> np.ndarray:
+        # Fractions of the segment from p0 to p1 where it crosses a grid line, starting with 0
+        fractions = [np.zeros(1)]
+        if c0 != c1:
+            lines = self.xmin + self.cell_width * np.arange(min(c0, c1) + 1, max(c0, c1) + 1)
+            fractions.append((lines - p0[0]) / (p1[0] - p0[0]))
+        if r0 != r1:
+            lines = self.ymin + self.cell_height * np.arange(min(r0, r1) + 1, max(r0, r1) + 1)
+            fractions.append((lines - p0[1]) / (p1[1] - p0[1]))
+        fractions = np.unique(np.concatenate(fractions))
+        return fractions[(fractions >= 0) & (fractions < 1)]
+
+
+class QuadGrid(CellGrid):
+    """
+    Hierarchical square grid dividing an extent into 2^level x 2^level cells. Cell ids are Morton codes (the bits
+    of the column and row interleaved), so the id of the parent of a cell is its id shifted two bits to the right.
+    Temporal points are encoded as temporal integers.
+
+        >>> grid = QuadGrid(470000, 6580000, 500000, 6610000, level=10)
+        >>> cells = grid.encode(trip)
+    """
+
+    def __init__(self, xmin: float, ymin: float, xmax: float, ymax: float, level: int):
+        # Ids must fit into the 32-bit values of temporal integers
+        if not 0 <= level <= 15:
+            raise ValueError(f'The level must be between 0 and 15, got {level}')
+        if xmax <= xmin or ymax <= ymin:
+            raise ValueError('The extent of the grid is empty')
+        side = 1 << level
+        super().__init__(xmin, ymin, (xmax - xmin) / side, (ymax - ymin) / side, side, side)
+        self.level = level
+
+    @staticmethod
+    def parent(ids: np.ndarray, levels: int = 1) -> np.ndarray:
+        """
+        Ids of the ancestors ``levels`` levels up of the given cells.
+        """
+        return np.asarray(ids) >> (2 * levels)
+
+    def ids(self, column: np.ndarray, row: np.ndarray) -> np.ndarray:
+        result = np.zeros(len(column), dtype=np.int64)
+        for bit in range(self.level):
+            result |= ((column >> bit) & 1) << (2 * bit)
+            result |= ((row >> bit) & 1) << (2 * bit + 1)
+        return result
+
+    def _instant(self, cell_id, timestamp: int) -> TIntInst:
+        return TIntInst(_inner=tintinst_make(int(cell_id), timestamp))
+
+    def _sequence(self, t: np.ndarray, ids: np.ndarray, lower_inc: bool, upper_inc: bool,
+                  interpolation: TInterpolation) -> TIntSeq:
+        return TIntSeq.from_arrays(t, ids, lower_inc, upper_inc, interpolation)
+
+
+class GeohashGrid(CellGrid):
+    """
+    Geohash cells of the given precision (number of characters) over longitude and latitude. Temporal points,
+    which must have geographic coordinates, are encoded as temporal texts.
+
+        >>> GeohashGrid(7).encode(vessel)
+    """
+
+    def __init__(self, precision: int):
+        if not 1 <= precision <= 12:
+            raise ValueError(f'The precision must be between 1 and 12, got {precision}')
+        bits = 5 * precision
+        self.precision = precision
+        self._lon_bits = (bits + 1) // 2
+        self._lat_bits = bits // 2
+        super().__init__(-180.0, -90.0, 360.0 / (1 << self._lon_bits), 180.0 / (1 << self._lat_bits),
+                         1 << self._lon_bits, 1 << self._lat_bits)
+
+    def ids(self, column: np.ndarray, row: np.ndarray) -> np.ndarray:
+        # Bits alternate starting with the longitude, from the most significant one
+        code = np.zeros(len(column), dtype=np.int64)
+        for bit in range(5 * self.precision):
+            if bit % 2 == 0:
+                value = (column >> (self._lon_bits - 1 - bit // 2)) & 1
+            else:
+                value = (row >> (self._lat_bits - 1 - bit // 2)) & 1
+            code = (code << 1) | value
+        characters = [_GEOHASH_ALPHABET[(code >> (5 * (self.precision - 1 - i))) & 31] for i in range(self.precision)]
+        if len(column) == 0:
+            return np.empty(0, dtype=f'<U{self.precision}')
+        return np.array([''.join(c) for c in zip(*characters)])
+
+    def _instant(self, cell_id, timestamp: int) -> TTextInst:
+        return TTextInst(_inner=ttextinst_make(str(cell_id), timestamp))
+
+    def _sequence(self, t: np.ndarray, ids: np.ndarray, lower_inc: bool, upper_inc: bool,
+                  interpolation: TInterpolation) -> TTextSeq:
+        return TTextSeq.from_arrays(t, ids, lower_inc, upper_inc, interpolation)
@@ -0,0 +1,103 @@
+from __future__ import annotations
+
+from functools import partial
+from typing import List, Optional, Union
+
+import numpy as np
+import shapely
+from pymeos_cffi import tpoint_to_geo_measure, gserialized_as_hexewkb, tpoint_speed, tfloatinst_make, \
+    tsequenceset_make
+
+from .common import sequence_arrays
+from ..arrays import datetime64_to_timestamptz_array
+from ..main import TPoint, TFloat, TFloatInst, TFloatSeq
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant, TSequenceSet
+
+# Seconds between the Unix epoch and the MEOS epoch (2000-01-01)
+_MEOS_EPOCH_SECONDS = 946684800
+
+
+class GeoMeasure:
+    """
+    Geometries with measures (LineStringM, MultiLineStringM, PointM...) built by ``tpoint_to_geo_measure``.
+
+    The measure is a temporal float defined over the time of the point, or one of:
+
+    - ``'time'``: Unix epoch seconds of every instant.
+    - ``'speed'``: speed of the point, to be used with ``segmentize`` so that every segment keeps its speed.
+
+    With ``segmentize``, the result has one geometry per segment so that every segment keeps its own measure.
+    Geometries are returned as EWKB, produced by MEOS, and can be decoded in bulk with ``shapely.from_wkb``.
+    """
+
+    @staticmethod
+    def wkb(tpoint: TPoint, measure: Union[str, TFloat] = 'time', segmentize: bool = False) -> bytes:
+        """
+        EWKB (little endian) of the geometry with measures of ``tpoint``.
+        """
+        if not isinstance(tpoint, TPoint):
+            raise TypeError(f'Operation not supported with type {tpoint.__class__}')
+        values = GeoMeasure._measure(tpoint, measure)
+        result = tpoint_to_geo_measure(tpoint._inner, values._inner, segmentize)
+        return bytes.fromhex(gserialized_as_hexewkb(result[0], 'NDR'))
+
+    @staticmethod
+    def geometry(tpoint: TPoint, measure: Union[str, TFloat] = 'time',
+                 segmentize: bool = False) -> shapely.Geometry:
+        """
+        Shapely geometry with measures of ``tpoint``.
+        """
+        return shapely.from_wkb(GeoMeasure.wkb(tpoint, measure, segmentize))
+
+    @staticmethod
+    def batch_wkb(tpoints: List[TPoint], measure: Union[str, List[TFloat]] = 'time', segmentize: bool = False,
+                  max_workers: Optional[int] = None) -> List[bytes]:
+        """
+        EWKB of the geometries with measures of every temporal point, computed on a thread pool. ``measure`` is
+        either one of the names accepted by :meth:`wkb` or a temporal float per temporal point.
+        """
+        if isinstance(measure, str):
+            return parallel_map(partial(GeoMeasure.wkb, measure=measure, segmentize=segmentize), tpoints,
+                                max_workers)
+        if len(measure) != len(tpoints):
+            raise ValueError(f'Got {len(measure)} measures for {len(tpoints)} temporal points')
+        return parallel_map(lambda pair: GeoMeasure.wkb(pair[0], pair[1], segmentize), list(zip(tpoints, measure)),
+                            max_workers)
+
+    @staticmethod
+    def batch(tpoints: List[TPoint], measure: Union[str, List[TFloat]] = 'time', segmentize: bool = False,
+              max_workers: Optional[int] = None) -> np.ndarray:
+        """
+        Array of shapely geometries with measures of every temporal point, decoded in one vectorized call.
+        """
+        return shapely.from_wkb(GeoMeasure.batch_wkb(tpoints, measure, segmentize, max_workers))
+
+    @staticmethod
+    def _measure(tpoint: TPoint, measure: Union[str, TFloat]) -> TFloat:
+        if isinstance(measure, TFloat):
+            return measure
+        if measure == 'speed':
+            if isinstance(tpoint, TInstant):
+                raise ValueError('The speed of a temporal instant is not defined')
+            return Temporal._factory(tpoint_speed(tpoint._inner))
+        if measure == 'time':
+            return GeoMeasure._epoch_seconds(tpoint)
+        raise ValueError(f'Unknown measure {measure}, expected time, speed or a temporal float')
+
+    @staticmethod
+    def _epoch_seconds(tpoint: TPoint) -> TFloat:
+        # Temporal float with the epoch seconds of the instants of the point and the same time frame
+        if isinstance(tpoint, TInstant):
+            t, _ = sequence_arrays(tpoint)
+            ts = int(datetime64_to_timestamptz_array(t)[0])
+            return TFloatInst(_inner=tfloatinst_make(ts / 1e6 + _MEOS_EPOCH_SECONDS, ts))
+        pieces = []
+        for sequence in tpoint.sequences:
+            t, _ = sequence_arrays(sequence)
+            seconds = datetime64_to_timestamptz_array(t) / 1e6 + _MEOS_EPOCH_SECONDS
+            pieces.append(TFloatSeq.from_arrays(t, seconds, sequence.lower_inc, sequence.upper_inc,
+                                                sequence.interpolation, normalize=False))
+        if not isinstance(tpoint, TSequenceSet):
+            return pieces[0]
+        return Temporal._factory(tsequenceset_make([p._inner for p in pieces], len(pieces), False))
@@ -0,0 +1,321 @@
+from __future__ import annotations
+
+import json
+from datetime import datetime
+from typing import Dict, List, Optional, Tuple, Union
+
+import numpy as np
+
+from pymeos_cffi import tsequenceset_make
+
+from .periods import PeriodBounds
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64, to_timestamptz_list
+from ..boxes import STBox
+from ..main import TPoint, TPointSeq, TGeogPoint, TFloat, TFloatSeq
+from ..temporal import Temporal, TInstant, TSequence, TInterpolation
+from ..time import Period, PeriodSet
+
+# Names of the interpolations in MF-JSON
+_MFJSON_INTERPOLATIONS = {TInterpolation.DISCRETE: 'Discrete', TInterpolation.STEPWISE: 'Step',
+                          TInterpolation.LINEAR: 'Linear'}
+
+
+class MultiAttributeTrajectory:
+    """
+    Trajectory with several measures sampled at the same instants, stored as columns sharing a single timestamp
+    array: the coordinates and one array per measure.
+
+    ``starts`` holds the index of the first instant of every sequence, so that trajectories with gaps are stored in
+    the same columns, and ``lower_inc`` and ``upper_inc`` whether the bounds of every sequence are inclusive (all of
+    them by default). Every column is interpolated with the interpolation of the trajectory.
+
+    The position and the measures are available as :class:`TPoint` and :class:`TFloat` values, built from the
+    columns the first time they are requested and then reused. Restrictions apply to all the columns at once and
+    return a new trajectory.
+
+        >>> ais = MultiAttributeTrajectory.from_temporals(position, sog=sog, cog=cog)
+        >>> harbour = ais.at(harbour_box)
+        >>> harbour['sog'].time_weighted_average()
+        >>> MultiAttributeTrajectory.from_mfjson(ais.as_mfjson())
+    """
+
+    def __init__(self, t: np.ndarray, x: np.ndarray, y: np.ndarray, z: Optional[np.ndarray] = None,
+                 measures: Optional[Dict[str, np.ndarray]] = None, starts: Optional[np.ndarray] = None,
+                 srid: int = 0, geodetic: bool = False, interpolation: TInterpolation = TInterpolation.LINEAR,
+                 lower_inc: Optional[np.ndarray] = None, upper_inc: Optional[np.ndarray] = None):
+        self.t = _timestamps(t)
+        self.x = np.asarray(x, dtype=float)
+        self.y = np.asarray(y, dtype=float)
+        self.z = None if z is None else np.asarray(z, dtype=float)
+        self.measures = {name: np.asarray(values, dtype=float) for name, values in (measures or {}).items()}
+        self.starts = np.zeros(1 if len(self.t) else 0, dtype=np.int64) if starts is None \
+            else np.asarray(starts, dtype=np.int64)
+        self.srid = srid
+        self.geodetic = geodetic
+        self.interpolation = interpolation
+        self.lower_inc = np.ones(len(self.starts), dtype=bool) if lower_inc is None \
+            else np.asarray(lower_inc, dtype=bool)
+        self.upper_inc = np.ones(len(self.starts), dtype=bool) if upper_inc is None \
+            else np.asarray(upper_inc, dtype=bool)
+        for name, column in [('x', self.x), ('y', self.y), ('z', self.z), *self.measures.items()]:
+            if column is not None and column.shape != self.t.shape:
+                raise ValueError(f'Column {name} has {len(column)} values for {len(self.t)} timestamps')
+        bounds = np.append(self.starts, len(self.t))
+        if len(self.t) and (self.starts[0] != 0 or (np.diff(bounds) <= 0).any()):
+            raise ValueError('The sequence starts must be increasing indexes starting at 0')
+        if self.lower_inc.shape != self.starts.shape or self.upper_inc.shape != self.starts.shape:
+            raise ValueError(f'The bound inclusivity must be given for the {len(self.starts)} sequences')
+        self._views: Dict[str, Temporal] = {}
+
+    @staticmethod
+    def from_temporals(position: TPoint, **measures: TFloat) -> MultiAttributeTrajectory:
+        """
+        Trajectory of a temporal point with the temporal floats given as measures. Measures defined at other
+        instants than the point are sampled at its instants by linear interpolation.
+        """
+        pieces = [position] if isinstance(position, (TInstant, TSequence)) else position.sequences
+        arrays = [piece.to_arrays() for piece in pieces]
+        t = np.concatenate([datetime64_to_timestamptz_array(a[0]) for a in arrays])
+        hasz = arrays[0][3] is not None
+        columns = {}
+        for name, measure in measures.items():
+            if not isinstance(measure, TFloat):
+                raise TypeError(f'Operation not supported with type {measure.__class__}')
+            mt, values = measure.to_arrays()
+            mt = datetime64_to_timestamptz_array(mt)
+            columns[name] = values.astype(float) if np.array_equal(mt, t) else np.interp(t, mt, values)
+        interpolation = position.interpolation if not isinstance(position, TInstant) else TInterpolation.LINEAR
+        instant = isinstance(position, TInstant)
+        return MultiAttributeTrajectory(t, np.concatenate([a[1] for a in arrays]),
+                                        np.concatenate([a[2] for a in arrays]),
+                                        np.concatenate([a[3] for a in arrays]) if hasz else None, columns,
+                                        np.cumsum([0] + [len(a[0]) for a in arrays[:-1]]), position.srid,
+                                        isinstance(position, TGeogPoint), interpolation,
+                                        [instant or piece.lower_inc for piece in pieces],
+                                        [instant or piece.upper_inc for piece in pieces])
+
+    def __len__(self):
+        return len(self.t)
+
+    def __getitem__(self, name: str) -> TFloat:
+        return self.measure(name)
+
+    @property
+    def timestamps(self) -> np.ndarray:
+        return timestamptz_array_to_datetime64(self.t)
+
+    @property
+    def num_sequences(self) -> int:
+        return len(self.starts)
+
+    @property
+    def position(self) -> TPoint:
+        """
+        Temporal point of the coordinates.
+        """
+        if 'position' not in self._views:
+            self._views['position'] = self._build(lambda lo, hi, lower_inc, upper_inc: TPointSeq.from_arrays(
+                self.t[lo:hi], self.x[lo:hi], self.y[lo:hi], None if self.z is None else self.z[lo:hi], self.srid,
+                self.geodetic, lower_inc, upper_inc, self.interpolation, False))
+        return self._views['position']
+
+    def measure(self, name: str) -> TFloat:
+        """
+        Temporal float of a measure.
+        """
+        if name not in self.measures:
+            raise KeyError(name)
+        key = 'measure:' + name
+        if key not in self._views:
+            values = self.measures[name]
+            self._views[key] = self._build(lambda lo, hi, lower_inc, upper_inc: TFloatSeq.from_arrays(
+                self.t[lo:hi], values[lo:hi], lower_inc, upper_inc, self.interpolation, False))
+        return self._views[key]
+
+    def at(self, other: Union[Period, PeriodSet, STBox, Tuple[datetime, datetime]]) -> MultiAttributeTrajectory:
+        """
+        Restriction of all the columns to a period, a period set, the periods during which the position is within
+        a box, or a pair of timestamps (both included). The values at the bounds of the periods are interpolated,
+        and the bounds of the sequences of the result are inclusive when they are in both the periods and the
+        trajectory.
+        """
+        if isinstance(other, STBox):
+            restricted = self.position.at(other)
+            if restricted is None:
+                return self._select([])
+            other = restricted.time
+        if isinstance(other, tuple):
+            lower, upper = to_timestamptz_list(list(other))
+            bounds = PeriodBounds.from_arrays(np.array([lower]), np.array([upper]), True, True)
+        elif isinstance(other, (Period, PeriodSet)):
+            bounds = PeriodBounds.from_periods([other])
+        else:
+            raise TypeError(f'Operation not supported with type {other.__class__}')
+        pieces = []
+        for (lo, hi), sequence_lower_inc, sequence_upper_inc in zip(self._sequence_bounds(), self.lower_inc.tolist(),
+                                                                     self.upper_inc.tolist()):
+            start, end = int(self.t[lo]), int(self.t[hi - 1])
+            for lower, upper, lower_inc, upper_inc in zip(bounds.lower.tolist(), bounds.upper.tolist(),
+                                                          bounds.lower_inc.tolist(), bounds.upper_inc.tolist()):
+                # A bound shared by the period and the sequence is inclusive if it is in both of them
+                if lower <= start:
+                    lower, lower_inc = start, sequence_lower_inc and (lower_inc or lower < start)
+                if upper >= end:
+                    upper, upper_inc = end, sequence_upper_inc and (upper_inc or upper > end)
+                if lower > upper or (lower == upper and not (lower_inc and upper_inc)):
+                    continue
+                pieces.append(self._clip(lo, hi, lower, upper, lower_inc, upper_inc))
+        return self._select(pieces)
+
+    def to_dataframe(self):
+        """
+        ``pandas.DataFrame`` indexed by time with the sequence, the coordinates and the measures.
+        """
+        from pandas import DataFrame
+        data = {'sequence': np.repeat(np.arange(self.num_sequences), np.diff(np.append(self.starts, len(self.t)))),
+                'x': self.x, 'y': self.y}
+        if self.z is not None:
+            data['z'] = self.z
+        data.update(self.measures)
+        return DataFrame(data, index=self.timestamps.astype('datetime64[ns]')).rename_axis('time')
+
+    def as_mfjson(self, precision: int = 15) -> str:
+        """
+        OGC Moving Features JSON feature with the position as temporal geometry and one temporal property per
+        measure. Sequence sets are written as in MEOS, with a list of sequences, and the measures of every sequence
+        are written as a separate entry of the temporal properties.
+        """
+        interpolation = _MFJSON_INTERPOLATIONS[self.interpolation]
+        columns = [self.x, self.y] if self.z is None else [self.x, self.y, self.z]
+        sequences, properties = [], []
+        for (lo, hi), lower_inc, upper_inc in zip(self._sequence_bounds(), self.lower_inc.tolist(),
+                                                  self.upper_inc.tolist()):
+            datetimes = np.datetime_as_string(self.timestamps[lo:hi], unit='us', timezone='UTC').tolist()
+            sequences.append({
+                'coordinates': np.round(np.column_stack(columns)[lo:hi], precision).tolist(),
+                'datetimes': datetimes,
+                'lower_inc': lower_inc,
+                'upper_inc': upper_inc,
+            })
+            entry = {'datetimes': datetimes}
+            for name, values in self.measures.items():
+                entry[name] = {'type': 'Measure', 'values': np.round(values[lo:hi], precision).tolist(),
+                               'interpolation': interpolation}
+            properties.append(entry)
+        geometry = {'type': 'MovingPoint'}
+        if len(sequences) == 1:
+            geometry.update(sequences[0])
+        else:
+            geometry['sequences'] = sequences
+        geometry['interpolation'] = interpolation
+        feature = {'type': 'Feature', 'temporalGeometry': geometry, 'temporalProperties': properties}
+        if self.srid:
+            feature['crs'] = {'type': 'Name', 'properties': {'name': f'EPSG:{self.srid}'}}
+        return json.dumps(feature)
+
+    @staticmethod
+    def from_mfjson(mfjson: str, geodetic: bool = False) -> MultiAttributeTrajectory:
+        """
+        Trajectory of an MF-JSON feature written by :meth:`as_mfjson` or with the same structure. Measures whose
+        datetimes differ from the ones of the geometry are sampled at them by linear interpolation.
+        """
+        feature = json.loads(mfjson)
+        geometry = feature.get('temporalGeometry', feature)
+        sequences = geometry.get('sequences', [geometry])
+        t = np.concatenate([_parse_datetimes(s['datetimes']) for s in sequences])
+        coordinates = np.concatenate([np.asarray(s['coordinates'], dtype=float).reshape(-1, len(s['coordinates'][0]))
+                                      for s in sequences])
+        starts = np.cumsum([0] + [len(s['datetimes']) for s in sequences[:-1]])
+        measure_t: Dict[str, List[np.ndarray]] = {}
+        measure_values: Dict[str, List[List[float]]] = {}
+        for entry in feature.get('temporalProperties', []):
+            datetimes = _parse_datetimes(entry['datetimes'])
+            for name, value in entry.items():
+                if name != 'datetimes':
+                    measure_t.setdefault(name, []).append(datetimes)
+                    measure_values.setdefault(name, []).append(value['values'])
+        measures = {}
+        for name in measure_t:
+            mt = np.concatenate(measure_t[name])
+            values = np.concatenate(measure_values[name]).astype(float)
+            measures[name] = values if np.array_equal(mt, t) else np.interp(t, mt, values)
+        crs = feature.get('crs', {}).get('properties', {}).get('name', '')
+        srid = int(crs.rsplit(':', 1)[-1]) if crs.rsplit(':', 1)[-1].isdigit() else 0
+        interpolation = {name: interp for interp, name in _MFJSON_INTERPOLATIONS.items()}[
+            geometry.get('interpolation', 'Linear')]
+        return MultiAttributeTrajectory(t, coordinates[:, 0], coordinates[:, 1],
+                                        coordinates[:, 2] if coordinates.shape[1] > 2 else None, measures, starts,
+                                        srid, geodetic, interpolation, [s.get('lower_inc', True) for s in sequences],
+                                        [s.get('upper_inc', True) for s in sequences])
+
+    def _sequence_bounds(self) -> List[Tuple[int, int]]:
+        bounds = np.append(self.starts, len(self.t)).tolist()
+        return list(zip(bounds[:-1], bounds[1:]))
+
+    def _build(self, make) -> Temporal:
+        if len(self.t) == 0:
+            raise ValueError('The trajectory is empty')
+        sequences = [make(lo, hi, lower_inc, upper_inc) for (lo, hi), lower_inc, upper_inc in
+                     zip(self._sequence_bounds(), self.lower_inc.tolist(), self.upper_inc.tolist())]
+        if len(sequences) == 1:
+            return sequences[0]
+        return Temporal._factory(tsequenceset_make([s._inner for s in sequences], len(sequences), True))
+
+    def _columns(self) -> List[Tuple[str, np.ndarray]]:
+        columns = [('x', self.x), ('y', self.y)] + ([('z', self.z)] if self.z is not None else [])
+        return columns + list(self.measures.items())
+
+    def _clip(self, lo: int, hi: int, lower: int, upper: int, lower_inc: bool,
+              upper_inc: bool) -> Tuple[np.ndarray, Dict[str, np.ndarray], bool, bool]:
+        # Instants of the sequence within the period, with interpolated instants at the bounds, and the inclusivity
+        # of the bounds of the piece
+        t = self.t[lo:hi]
+        # Discrete trajectories are only defined at their instants, which are dropped on exclusive bounds
+        continuous = self.interpolation != TInterpolation.DISCRETE
+        first = np.searchsorted(t, lower, side='left' if continuous or lower_inc else 'right')
+        last = np.searchsorted(t, upper, side='right' if continuous or upper_inc else 'left')
+        times = t[first:last]
+        prepend = continuous and (len(times) == 0 or times[0] != lower)
+        append = continuous and upper != lower and (len(times) == 0 or times[-1] != upper)
+        times = np.concatenate([[lower] if prepend else [], times, [upper] if append else []]).astype(np.int64)
+        columns = {}
+        for name, column in self._columns():
+            values = column[lo:hi]
+            if self.interpolation == TInterpolation.LINEAR:
+                columns[name] = np.interp(times, t, values)
+            else:
+                columns[name] = values[np.maximum(np.searchsorted(t, times, side='right') - 1, 0)]
+                if self.interpolation == TInterpolation.STEPWISE and not upper_inc and len(times) > 1:
+                    # MEOS requires the value at an exclusive upper bound to be the value before it
+                    columns[name][-1] = columns[name][-2]
+        if not continuous:
+            return times, columns, True, True
+        return times, columns, lower_inc, upper_inc
+
+    def _select(self, pieces: List[Tuple[np.ndarray, Dict[str, np.ndarray], bool, bool]]) -> MultiAttributeTrajectory:
+        pieces = [piece for piece in pieces if len(piece[0]) > 0]
+        names = [name for name, _ in self._columns()]
+        columns = {name: np.concatenate([piece[1][name] for piece in pieces]) if pieces else np.empty(0)
+                   for name in names}
+        return MultiAttributeTrajectory(
+            np.concatenate([piece[0] for piece in pieces]) if pieces else np.empty(0, dtype=np.int64),
+            columns['x'], columns['y'], columns.get('z'), {name: columns[name] for name in self.measures},
+            np.cumsum([0] + [len(piece[0]) for piece in pieces[:-1]]) if pieces else None,
+            self.srid, self.geodetic, self.interpolation, [piece[2] for piece in pieces],
+            [piece[3] for piece in pieces])
+
+
+def _timestamps(values) -> np.ndarray:
+    values = np.asarray(values)
+    if np.issubdtype(values.dtype, np.datetime64):
+        return datetime64_to_timestamptz_array(values)
+    if values.dtype == object or np.issubdtype(values.dtype, np.str_):
+        return np.array(to_timestamptz_list(values.tolist()), dtype=np.int64)
+    return values.astype(np.int64)
+
+
+def _parse_datetimes(datetimes: List[str]) -> np.ndarray:
+    # ISO datetimes in UTC are parsed by numpy, other offsets by MEOS
+    if all(d.endswith('Z') for d in datetimes):
+        return datetime64_to_timestamptz_array(np.array([d[:-1] for d in datetimes], dtype='datetime64[us]'))
+    return np.array(to_timestamptz_list(datetimes), dtype=np.int64)
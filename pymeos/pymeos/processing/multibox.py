@@ -0,0 +1,161 @@
+from __future__ import annotations
+
+import heapq
+from functools import partial
+from typing import List, Optional, Tuple
+
+import numpy as np
+from pymeos_cffi import stbox_make, period_make
+
+from .common import sequence_arrays
+from ..arrays import datetime64_to_timestamptz_array
+from ..boxes import STBox
+from ..main import TPoint, TGeogPoint
+from ..parallel import parallel_map
+from ..temporal import TInstant, TInterpolation
+
+
+class MultiBox:
+    """
+    Approximations of temporal points by at most ``k`` spatiotemporal boxes, to be used as index keys.
+
+    One box per trajectory has a poor selectivity for long winding routes, and one box per segment
+    (``TPoint.stboxes``) makes too many keys. Here, consecutive segments are grouped so that every group is covered
+    by one box:
+
+    - ``'equisplit'`` groups the same number of consecutive segments in every box.
+    - ``'merge'`` starts with one box per segment and repeatedly merges the two adjacent boxes whose union adds the
+      least volume (space x time, with time in seconds, flat extents being slightly padded), breaking ties by the
+      least margin, until ``k`` remain.
+
+    Boxes are computed on the coordinates of the instants. Only geometric points are supported.
+    """
+
+    @staticmethod
+    def split(tpoint: TPoint, max_boxes: int, method: str = 'merge') -> List[STBox]:
+        """
+        Boxes covering ``tpoint``, at most ``max_boxes``, in temporal order.
+        """
+        srid = tpoint.srid
+        return [MultiBox._to_stbox(row, srid) for row in MultiBox.split_arrays(tpoint, max_boxes, method)]
+
+    @staticmethod
+    def split_arrays(tpoint: TPoint, max_boxes: int, method: str = 'merge') -> np.ndarray:
+        """
+        Boxes covering ``tpoint`` as rows ``xmin, ymin, [zmin,] tmin, xmax, ymax, [zmax,] tmax``, with the
+        timestamps as MEOS timestamps (microseconds since 2000-01-01 UTC). This is the interleaved layout expected
+        by R-tree implementations such as ``rtree``.
+        """
+        if not isinstance(tpoint, TPoint):
+            raise TypeError(f'Operation not supported with type {tpoint.__class__}')
+        if isinstance(tpoint, TGeogPoint):
+            raise ValueError('Multi-box approximations are only supported for geometric points')
+        if max_boxes < 1:
+            raise ValueError(f'The number of boxes must be positive, got {max_boxes}')
+        lower, upper = MultiBox._unit_boxes(tpoint)
+        if method == 'equisplit':
+            bounds = np.unique(np.linspace(0, len(lower), min(max_boxes, len(lower)) + 1).round().astype(int))
+        elif method == 'merge':
+            bounds = MultiBox._merge_bounds(lower, upper, max_boxes)
+        else:
+            raise ValueError(f'Unknown method {method}, expected equisplit or merge')
+        starts = bounds[:-1]
+        return np.hstack([np.minimum.reduceat(lower, starts), np.maximum.reduceat(upper, starts)])
+
+    @staticmethod
+    def batch(tpoints: List[TPoint], max_boxes: int, method: str = 'merge',
+              max_workers: Optional[int] = None) -> List[List[STBox]]:
+        """
+        Splits every temporal point on a thread pool.
+        """
+        return parallel_map(partial(MultiBox.split, max_boxes=max_boxes, method=method), tpoints, max_workers)
+
+    @staticmethod
+    def batch_arrays(tpoints: List[TPoint], max_boxes: int, method: str = 'merge', max_workers: Optional[int] = None,
+                     hasz: bool = False) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Boxes of all the temporal points for bulk loading an index: the position of the temporal point in
+        ``tpoints`` of every box and the boxes as returned by ``split_arrays``. ``hasz`` only sets the number of
+        columns of the boxes when ``tpoints`` is empty.
+        """
+        boxes = parallel_map(partial(MultiBox.split_arrays, max_boxes=max_boxes, method=method), tpoints,
+                             max_workers)
+        if not boxes:
+            return np.empty(0, dtype=np.int64), np.empty((0, 8 if hasz else 6))
+        index = np.concatenate([np.full(len(b), n) for n, b in enumerate(boxes)])
+        return index, np.vstack(boxes)
+
+    @staticmethod
+    def _unit_boxes(tpoint: TPoint) -> Tuple[np.ndarray, np.ndarray]:
+        # Lower and upper corners (x, y, [z,] t) of the box of every segment, or of every instant of discrete
+        # sequences, in temporal order
+        lower, upper = [], []
+        sequences = [tpoint] if isinstance(tpoint, TInstant) else tpoint.sequences
+        for sequence in sequences:
+            t, coords = sequence_arrays(sequence)
+            points = np.column_stack([coords, datetime64_to_timestamptz_array(t).astype(float)])
+            if len(points) == 1 or sequence.interpolation == TInterpolation.DISCRETE:
+                lower.append(points)
+                upper.append(points)
+            else:
+                lower.append(np.minimum(points[:-1], points[1:]))
+                upper.append(np.maximum(points[:-1], points[1:]))
+        return np.vstack(lower), np.vstack(upper)
+
+    @staticmethod
+    def _merge_bounds(lower: np.ndarray, upper: np.ndarray, max_boxes: int) -> np.ndarray:
+        # Start indexes of the groups of units (followed by the number of units) after the greedy merges
+        n = len(lower)
+        # Time in seconds so that the margin is not dominated by microseconds
+        scale = np.ones(lower.shape[1])
+        scale[-1] = 1e-6
+        lower, upper = lower * scale, upper * scale
+        # Flat extents, such as those of axis-aligned segments, are padded so that their volume is not zero and
+        # merges growing them still compare by the extents they span
+        extent = upper.max(axis=0) - lower.min(axis=0)
+        padding = np.where(extent > 0, extent, 1.0) * 1e-6
+        following = np.arange(1, n + 1)
+        previous = np.arange(-1, n - 1)
+        version = np.zeros(n, dtype=np.int64)
+        alive = np.ones(n, dtype=bool)
+
+        def cost(i: int, j: int) -> Tuple[float, float]:
+            low, high = np.minimum(lower[i], lower[j]), np.maximum(upper[i], upper[j])
+            volume = np.prod(high - low + padding) - np.prod(upper[i] - lower[i] + padding) - \
+                np.prod(upper[j] - lower[j] + padding)
+            margin = np.sum(high - low) - np.sum(upper[i] - lower[i]) - np.sum(upper[j] - lower[j])
+            return float(volume), float(margin)
+
+        heap = [(*cost(i, i + 1), i, 0, 0) for i in range(n - 1)]
+        heapq.heapify(heap)
+        count = n
+        while count > max_boxes and heap:
+            _, _, i, version_i, version_j = heapq.heappop(heap)
+            j = following[i]
+            if not alive[i] or j >= n or version[i] != version_i or version[j] != version_j:
+                continue
+            # Merge j into i
+            lower[i], upper[i] = np.minimum(lower[i], lower[j]), np.maximum(upper[i], upper[j])
+            alive[j] = False
+            following[i] = following[j]
+            if following[i] < n:
+                previous[following[i]] = i
+            version[i] += 1
+            count -= 1
+            if following[i] < n:
+                k = following[i]
+                heapq.heappush(heap, (*cost(i, k), i, version[i], version[k]))
+            if previous[i] >= 0:
+                h = previous[i]
+                heapq.heappush(heap, (*cost(h, i), h, version[h], version[i]))
+        return np.append(np.flatnonzero(alive), n)
+
+    @staticmethod
+    def _to_stbox(row: np.ndarray, srid: int) -> STBox:
+        half = len(row) // 2
+        hasz = half == 4
+        low, high = row[:half], row[half:]
+        period = period_make(int(low[-1]), int(high[-1]), True, True)
+        zmin, zmax = (float(low[2]), float(high[2])) if hasz else (0.0, 0.0)
+        return STBox(_inner=stbox_make(period, True, hasz, False, srid, float(low[0]), float(high[0]),
+                                       float(low[1]), float(high[1]), zmin, zmax))
@@ -0,0 +1,229 @@
+from __future__ import annotations
+
+from datetime import timedelta
+from functools import partial
+from typing import List, Optional, Sequence, Tuple
+
+import numpy as np
+import shapely
+import shapely.geometry.base as shpb
+from pymeos_cffi import tintinst_make, tfloatinst_make, tsequenceset_make
+
+from .common import sequence_arrays
+from ..arrays import datetime64_to_timestamptz_array
+from ..main import TPoint, TGeogPoint, TInt, TIntInst, TIntSeq, TFloat, TFloatInst, TFloatSeq
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant, TSequenceSet, TInterpolation
+
+# Maximum number of samples per segment used to locate changes of nearest non-point feature
+_MAX_SAMPLES = 64
+
+
+class NearestFeatureIndex:
+    """
+    Spatially indexed set of static features (points, lines or polygons) answering which feature is the nearest
+    to a temporal point at every moment.
+
+    Features are identified by their position in the given sequence. Distances are planar, in units of the SRID of
+    the features, which must be the one of the temporal points. For point features, the instants where the
+    nearest feature changes are computed exactly: along a segment of a linear trajectory, the squared distances
+    to two points differ by a linear function of time. For other features they are located by sampling every
+    segment and bisecting the changes down to a time tolerance.
+
+    The distance is a linear temporal float, while the true distance to a feature along a segment is not linear in
+    time (a hyperbola for point features). It is exact at the instants of the temporal point, at the changes of
+    nearest feature and at the closest approach of every segment to its nearest feature. In between it is linearly
+    interpolated, which overestimates the distance to point features, and non-point features are also sampled
+    at the time tolerance, with at most ``_MAX_SAMPLES`` samples per segment.
+
+        >>> ports = NearestFeatureIndex(port_geometries)
+        >>> port, distance = ports.assign(vessel)
+    """
+
+    def __init__(self, features: Sequence):
+        self.geometries = np.array([_to_shapely(f) for f in features], dtype=object)
+        if len(self.geometries) == 0:
+            raise ValueError('At least one feature is required')
+        self._tree = shapely.STRtree(self.geometries)
+        self._is_point = shapely.get_type_id(self.geometries) == 0
+        self._points = np.full((len(self.geometries), 2), np.nan)
+        self._points[self._is_point] = shapely.get_coordinates(self.geometries[self._is_point])[:, :2]
+
+    def __len__(self):
+        return len(self.geometries)
+
+    def nearest(self, x: np.ndarray, y: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Index of and distance to the nearest feature of every position.
+        """
+        (positions, features), distances = self._tree.query_nearest(shapely.points(x, y), return_distance=True,
+                                                                    all_matches=False)
+        order = np.argsort(positions, kind='stable')
+        return features[order], distances[order]
+
+    def assign(self, tpoint: TPoint, tolerance: timedelta = timedelta(seconds=1)) -> Tuple[TInt, TFloat]:
+        """
+        Returns a step temporal integer with the index of the nearest feature and a temporal float with the
+        distance to it, both defined over the time of ``tpoint``. The distance is an approximation, linearly
+        interpolated between the instants where it is exact, see :class:`NearestFeatureIndex`.
+
+        Args:
+            tpoint: temporal geometric point.
+            tolerance: precision of the instants where the nearest feature changes when they are searched by
+                bisection, that is, for non-point features.
+        """
+        if not isinstance(tpoint, TPoint):
+            raise TypeError(f'Operation not supported with type {tpoint.__class__}')
+        if isinstance(tpoint, TGeogPoint):
+            raise ValueError('Nearest features are computed with planar distances, transform geographic points first')
+        if isinstance(tpoint, TInstant):
+            t, coords = sequence_arrays(tpoint)
+            feature, distance = self.nearest(coords[:, 0], coords[:, 1])
+            ts = int(datetime64_to_timestamptz_array(t)[0])
+            return TIntInst(_inner=tintinst_make(int(feature[0]), ts)), \
+                TFloatInst(_inner=tfloatinst_make(float(distance[0]), ts))
+        tolerance_us = max(1, int(tolerance / timedelta(microseconds=1)))
+        pieces = [self._assign_sequence(sequence, tolerance_us) for sequence in tpoint.sequences]
+        if not isinstance(tpoint, TSequenceSet):
+            return pieces[0]
+        features = Temporal._factory(tsequenceset_make([p[0]._inner for p in pieces], len(pieces), True))
+        distances = Temporal._factory(tsequenceset_make([p[1]._inner for p in pieces], len(pieces), True))
+        return features, distances
+
+    def assign_batch(self, tpoints: List[TPoint], tolerance: timedelta = timedelta(seconds=1),
+                     max_workers: Optional[int] = None) -> List[Tuple[TInt, TFloat]]:
+        """
+        Assigns the nearest feature to every temporal point on a thread pool.
+        """
+        return parallel_map(partial(self.assign, tolerance=tolerance), tpoints, max_workers)
+
+    def _assign_sequence(self, sequence: TPoint, tolerance: int) -> Tuple[TIntSeq, TFloatSeq]:
+        t, coords = sequence_arrays(sequence)
+        t = datetime64_to_timestamptz_array(t)
+        xy = coords[:, :2]
+        feature, distance = self.nearest(xy[:, 0], xy[:, 1])
+        interpolation = sequence.interpolation
+        if interpolation != TInterpolation.LINEAR or len(t) == 1:
+            # The position, hence the nearest feature, only changes at the instants
+            return TIntSeq.from_arrays(t, feature, sequence.lower_inc, sequence.upper_inc, interpolation), \
+                TFloatSeq.from_arrays(t, distance, sequence.lower_inc, sequence.upper_inc, interpolation)
+        step_t, step_feature, distance_t, distance_value = [], [], [], []
+        for k in range(len(t) - 1):
+            p0, p1 = xy[k], xy[k + 1]
+            changes = self._segment_changes(p0, p1, t[k], t[k + 1], feature[k], distance[k], distance[k + 1],
+                                            tolerance)
+            bounds = [s for s, _ in changes] + [1.0]
+            for (start, f), end in zip(changes, bounds[1:]):
+                step_t.append(t[k] + round(start * (t[k + 1] - t[k])))
+                step_feature.append(f)
+                for s in self._distance_fractions(f, p0, p1, start, end, t[k + 1] - t[k], tolerance):
+                    distance_t.append(t[k] + round(s * (t[k + 1] - t[k])))
+                    distance_value.append(shapely.distance(self.geometries[f], shapely.points(p0 + s * (p1 - p0))))
+        step_t.append(t[-1])
+        step_feature.append(feature[-1])
+        distance_t.append(t[-1])
+        distance_value.append(distance[-1])
+        step_t, step_feature = _unique_times(np.array(step_t), np.array(step_feature), keep='last')
+        distance_t, distance_value = _unique_times(np.array(distance_t), np.array(distance_value), keep='first')
+        return TIntSeq.from_arrays(step_t, step_feature, sequence.lower_inc, sequence.upper_inc), \
+            TFloatSeq.from_arrays(distance_t, distance_value, sequence.lower_inc, sequence.upper_inc)
+
+    def _segment_changes(self, p0: np.ndarray, p1: np.ndarray, t0: int, t1: int, first: int, d0: float, d1: float,
+                         tolerance: int) -> List[Tuple[float, int]]:
+        # Fractions of the segment where the nearest feature changes, starting with the one nearest to p0
+        length = float(np.hypot(*(p1 - p0)))
+        if length == 0:
+            return [(0.0, first)]
+        # Some feature is always within this distance of the segment (the nearest to p0 or the nearest to p1)
+        reach = max(d0, d1) + length / 2
+        lo, hi = np.minimum(p0, p1) - reach, np.maximum(p0, p1) + reach
+        candidates = self._tree.query(shapely.box(lo[0], lo[1], hi[0], hi[1]))
+        segment = shapely.linestrings([p0, p1])
+        candidates = candidates[shapely.distance(self.geometries[candidates], segment) <= reach]
+        if len(candidates) <= 1:
+            return [(0.0, first)]
+        if self._is_point[candidates].all():
+            return self._point_envelope(candidates, p0, p1)
+        return self._sampled_changes(candidates, p0, p1, t1 - t0, tolerance)
+
+    def _point_envelope(self, candidates: np.ndarray, p0: np.ndarray, p1: np.ndarray) -> List[Tuple[float, int]]:
+        # |p0 + s(p1 - p0) - a|^2 minus the term shared by all the features is the line b + m * s
+        offset = p0 - self._points[candidates]
+        slope = 2 * offset @ (p1 - p0)
+        intercept = (offset ** 2).sum(axis=1)
+        current = int(np.lexsort((slope, intercept))[0])
+        s = 0.0
+        changes = [(0.0, int(candidates[current]))]
+        while True:
+            steeper = slope < slope[current]
+            if not steeper.any():
+                break
+            crossing = np.full(len(candidates), np.inf)
+            crossing[steeper] = (intercept[steeper] - intercept[current]) / (slope[current] - slope[steeper])
+            crossing[crossing <= s] = np.inf
+            s = float(crossing.min())
+            if s >= 1.0:
+                break
+            tied = np.flatnonzero(crossing == s)
+            current = int(tied[np.argmin(slope[tied])])
+            changes.append((s, int(candidates[current])))
+        return changes
+
+    def _sampled_changes(self, candidates: np.ndarray, p0: np.ndarray, p1: np.ndarray, duration: int,
+                         tolerance: int) -> List[Tuple[float, int]]:
+        geometries = self.geometries[candidates]
+
+        def nearest_at(fractions: np.ndarray) -> np.ndarray:
+            positions = shapely.points(p0 + fractions[:, None] * (p1 - p0))
+            return candidates[np.argmin(shapely.distance(geometries[:, None], positions[None, :]), axis=0)]
+
+        fractions = np.linspace(0.0, 1.0, min(_MAX_SAMPLES, max(2, -(-duration // tolerance))) + 1)
+        nearest = nearest_at(fractions)
+        changes = [(0.0, int(nearest[0]))]
+        precision = tolerance / duration
+        for k in np.flatnonzero(nearest[1:] != nearest[:-1]):
+            lo, hi = fractions[k], fractions[k + 1]
+            while hi - lo > precision:
+                middle = (lo + hi) / 2
+                if nearest_at(np.array([middle]))[0] == nearest[k]:
+                    lo = middle
+                else:
+                    hi = middle
+            changes.append((float(hi), int(nearest[k + 1])))
+        return changes
+
+    def _distance_fractions(self, feature: int, p0: np.ndarray, p1: np.ndarray, start: float, end: float,
+                            duration: int, tolerance: int) -> np.ndarray:
+        # Fractions where the distance to the feature is sampled so that its linear interpolation follows it,
+        # including the closest approach of the segment, where the distance reaches its minimum
+        direction = p1 - p0
+        if not direction.any():
+            return np.array([start])
+        if self._is_point[feature]:
+            closest = float((self._points[feature] - p0) @ direction / (direction @ direction))
+            return np.array([start, closest] if start < closest < end else [start])
+        nearest = shapely.get_coordinates(shapely.shortest_line(shapely.linestrings([p0, p1]),
+                                                                self.geometries[feature]))[0]
+        closest = float((nearest - p0) @ direction / (direction @ direction))
+        samples = min(_MAX_SAMPLES, max(1, int((end - start) * duration // tolerance)))
+        fractions = np.linspace(start, end, samples, endpoint=False)
+        return np.union1d(fractions, [closest]) if start < closest < end else fractions
+
+
+def _to_shapely(feature) -> shpb.BaseGeometry:
+    if isinstance(feature, shpb.BaseGeometry):
+        return feature
+    if hasattr(feature, 'to_ewkb'):
+        # postgis geometries
+        return shapely.from_wkb(feature.to_ewkb())
+    raise TypeError(f'Operation not supported with type {feature.__class__}')
+
+
+def _unique_times(t: np.ndarray, values: np.ndarray, keep: str) -> Tuple[np.ndarray, np.ndarray]:
+    # Timestamps are rounded to microseconds, so consecutive changes may collapse into the same instant
+    t = t.astype(np.int64)
+    if keep == 'last':
+        mask = np.append(t[1:] != t[:-1], True)
+    else:
+        mask = np.insert(t[1:] != t[:-1], 0, True)
+    return t[mask], values[mask]
@@ -0,0 +1,208 @@
+from __future__ import annotations
+
+from dataclasses import dataclass
+from datetime import datetime, timedelta
+from functools import partial
+from typing import Hashable, List, Optional, Sequence
+
+import numpy as np
+import shapely
+from pymeos_cffi import tpoint_get_coord, tfloat_start_value, tfloat_end_value, temporal_start_timestamp, \
+    temporal_end_timestamp
+
+from .common import sequence_arrays
+from .nearest import _to_shapely
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64, to_timestamptz_list
+from ..main import TPoint
+from ..parallel import parallel_map
+
+# Default origin of MEOS temporal buckets (Monday 2000-01-03)
+BUCKET_ORIGIN = datetime(2000, 1, 3)
+
+
+@dataclass
+class ODMatrix:
+    """
+    Origin-destination matrix stored sparsely: entry ``i`` counts ``count[i]`` trips departing from zone
+    ``origin[i]`` to zone ``destination[i]`` in time bucket ``bucket[i]``, lasting ``duration[i]`` seconds in
+    total. Zones are positions in ``zones`` and buckets positions in ``buckets``, which is ``None`` when trips are not
+    bucketed by departure time. ``unassigned`` counts the trips whose origin or destination lies in no zone.
+    """
+    zones: np.ndarray
+    buckets: Optional[np.ndarray]
+    bucket: np.ndarray
+    origin: np.ndarray
+    destination: np.ndarray
+    count: np.ndarray
+    duration: np.ndarray
+    unassigned: int
+
+    def counts(self) -> np.ndarray:
+        """
+        Dense matrix of trip counts, of shape (zones, zones), or (buckets, zones, zones) when bucketed.
+        """
+        return self._dense(self.count, np.int64)
+
+    def durations(self) -> np.ndarray:
+        """
+        Dense matrix of the total duration of the trips in seconds.
+        """
+        return self._dense(self.duration, float)
+
+    def mean_durations(self) -> np.ndarray:
+        """
+        Dense matrix of the mean duration of the trips in seconds, ``nan`` where there are none.
+        """
+        counts = self.counts()
+        return np.divide(self.durations(), counts, out=np.full(counts.shape, np.nan), where=counts > 0)
+
+    def to_dataframe(self):
+        """
+        Non-empty entries as a ``pandas.DataFrame`` with the zone ids and the start of the buckets.
+        """
+        from pandas import DataFrame
+        data = {
+            'origin': self.zones[self.origin],
+            'destination': self.zones[self.destination],
+            'count': self.count,
+            'duration': self.duration,
+        }
+        if self.buckets is not None:
+            data = {'bucket': self.buckets[self.bucket], **data}
+        return DataFrame(data)
+
+    def _dense(self, values: np.ndarray, dtype) -> np.ndarray:
+        n = len(self.zones)
+        if self.buckets is None:
+            result = np.zeros((n, n), dtype=dtype)
+            np.add.at(result, (self.origin, self.destination), values)
+        else:
+            result = np.zeros((len(self.buckets), n, n), dtype=dtype)
+            np.add.at(result, (self.bucket, self.origin, self.destination), values)
+        return result
+
+
+class OriginDestination:
+    """
+    Origin-destination matrices between zones from collections of temporal points.
+
+    Trip endpoints are read as coordinates from MEOS, without building geometries, and assigned to the zones with
+    an STRtree in one vectorized query. Trips can be split at their stops, in which case every movement between
+    stops is counted as a trip.
+    """
+
+    @staticmethod
+    def matrix(trips: List[TPoint], zones: Sequence, zone_ids: Optional[Sequence[Hashable]] = None,
+               bucket_width: Optional[timedelta] = None, bucket_origin: datetime = BUCKET_ORIGIN,
+               stop_radius: Optional[float] = None, stop_duration: Optional[timedelta] = None,
+               max_workers: Optional[int] = None) -> ODMatrix:
+        """
+        Counts the trips between every pair of zones.
+
+        Args:
+            trips: temporal points, in the SRID of the zones.
+            zones: polygons (shapely or postgis). A point lying in several zones is assigned to the first one.
+            zone_ids: identifiers of the zones, their positions by default.
+            bucket_width: width of the buckets of departure time, as in ``timestamptz_bucket``. Trips are not
+                bucketed by default.
+            bucket_origin: origin of the buckets.
+            stop_radius: distance within which a point staying ``stop_duration`` is considered stopped.
+            stop_duration: minimum duration of a stop. Trips are split at their stops, and at gaps longer than
+                this, when both stop parameters are given.
+            max_workers: threads used to extract the endpoints.
+        """
+        geometries = np.array([_to_shapely(z) for z in zones], dtype=object)
+        zone_ids = np.asarray(zone_ids if zone_ids is not None else np.arange(len(geometries)))
+        if len(zone_ids) != len(geometries):
+            raise ValueError(f'Got {len(zone_ids)} ids for {len(geometries)} zones')
+        if (stop_radius is None) != (stop_duration is None):
+            raise ValueError('Both stop_radius and stop_duration are required to split trips at stops')
+        for trip in trips:
+            if not isinstance(trip, TPoint):
+                raise TypeError(f'Operation not supported with type {trip.__class__}')
+
+        if stop_radius is None:
+            rows = parallel_map(OriginDestination._endpoints, trips, max_workers)
+        else:
+            rows = parallel_map(partial(OriginDestination._stop_endpoints, radius=stop_radius,
+                                        duration=int(stop_duration / timedelta(microseconds=1))),
+                                trips, max_workers)
+        rows = np.concatenate(rows) if rows else np.empty((0, 6))
+        start, end = rows[:, 0].astype(np.int64), rows[:, 3].astype(np.int64)
+        origin = OriginDestination._assign(geometries, rows[:, 1], rows[:, 2])
+        destination = OriginDestination._assign(geometries, rows[:, 4], rows[:, 5])
+        assigned = (origin >= 0) & (destination >= 0)
+        start, end, origin, destination = start[assigned], end[assigned], origin[assigned], destination[assigned]
+
+        if bucket_width is None:
+            buckets = None
+            bucket = np.zeros(len(start), dtype=np.int64)
+        else:
+            width = int(bucket_width / timedelta(microseconds=1))
+            if width <= 0:
+                raise ValueError(f'The bucket width must be positive, got {bucket_width}')
+            first_bucket = to_timestamptz_list([bucket_origin])[0]
+            number = (start - first_bucket) // width
+            low = number.min() if len(number) > 0 else 0
+            high = number.max() if len(number) > 0 else -1
+            bucket = number - low
+            buckets = timestamptz_array_to_datetime64(first_bucket + width * np.arange(low, high + 1))
+
+        keys, inverse, count = np.unique(np.column_stack([bucket, origin, destination]), axis=0, return_inverse=True,
+                                         return_counts=True)
+        inverse = inverse.reshape(-1)
+        duration = np.zeros(len(keys))
+        np.add.at(duration, inverse, (end - start) / 1e6)
+        return ODMatrix(zone_ids, buckets, keys[:, 0], keys[:, 1], keys[:, 2], count, duration,
+                        int((~assigned).sum()))
+
+    @staticmethod
+    def _assign(geometries: np.ndarray, x: np.ndarray, y: np.ndarray) -> np.ndarray:
+        # Zone of every point (the first when several contain it), -1 for points outside of all zones
+        result = np.full(len(x), -1, dtype=np.int64)
+        if len(x) == 0:
+            return result
+        points, zones = shapely.STRtree(geometries).query(shapely.points(x, y), predicate='within')
+        order = np.lexsort((zones, points))
+        points, zones = points[order], zones[order]
+        first = np.insert(points[1:] != points[:-1], 0, True)
+        result[points[first]] = zones[first]
+        return result
+
+    @staticmethod
+    def _endpoints(trip: TPoint) -> np.ndarray:
+        # Start timestamp, X and Y and end timestamp, X and Y of the trip
+        x = tpoint_get_coord(trip._inner, 0)
+        y = tpoint_get_coord(trip._inner, 1)
+        return np.array([[temporal_start_timestamp(trip._inner), tfloat_start_value(x), tfloat_start_value(y),
+                          temporal_end_timestamp(trip._inner), tfloat_end_value(x), tfloat_end_value(y)]],
+                        dtype=float)
+
+    @staticmethod
+    def _stop_endpoints(trip: TPoint, radius: float, duration: int) -> np.ndarray:
+        # Endpoints of the movements between stops: a stop is a maximal run of instants lasting at least
+        # ``duration`` within ``radius`` of its first instant, or a gap of at least ``duration``
+        t, coords = sequence_arrays(trip)
+        t = datetime64_to_timestamptz_array(t)
+        xy = coords[:, :2]
+        n = len(t)
+        rows = []
+        departure = 0
+        i = 0
+        while i < n - 1:
+            if t[i + 1] - t[i] >= duration:
+                arrival, resume = i, i + 1
+            else:
+                j = i + 1
+                while j < n and np.hypot(*(xy[j] - xy[i])) <= radius:
+                    j += 1
+                if t[j - 1] - t[i] < duration:
+                    i += 1
+                    continue
+                arrival, resume = i, j - 1
+            if arrival > departure:
+                rows.append([t[departure], *xy[departure], t[arrival], *xy[arrival]])
+            departure = i = resume
+        if n - 1 > departure:
+            rows.append([t[departure], *xy[departure], t[-1], *xy[-1]])
+        return np.array(rows, dtype=float).reshape(-1, 6)
@@ -0,0 +1,193 @@
+from __future__ import annotations
+
+from dataclasses import dataclass
+from datetime import timedelta
+from typing import List, Sequence, Tuple, Union
+
+import numpy as np
+
+from pymeos_cffi import period_make, periodset_make, periodset_periods, period_lower, period_upper
+
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64
+from ..time import Period, PeriodSet
+
+# Bounds are mapped to a doubled axis so that every period becomes half-open: a point 2t is the timestamp t and 2t+1
+# the open interval just after it, which keeps the sweep exact for inclusive and exclusive bounds
+_MAX_TIMESTAMP = 2 ** 61
+
+
+@dataclass
+class PeriodBounds:
+    """
+    Columnar periods: MEOS timestamps (microseconds since 2000-01-01) of the lower and upper bounds and whether
+    they are inclusive, as numpy arrays.
+    """
+    lower: np.ndarray
+    upper: np.ndarray
+    lower_inc: np.ndarray
+    upper_inc: np.ndarray
+
+    def __len__(self):
+        return len(self.lower)
+
+    @staticmethod
+    def from_arrays(lower: np.ndarray, upper: np.ndarray, lower_inc: Union[bool, np.ndarray] = True,
+                    upper_inc: Union[bool, np.ndarray] = False) -> PeriodBounds:
+        """
+        Periods from arrays of bounds given as ``datetime64`` or MEOS timestamps, with the inclusivity of the bounds
+        given per period or for all of them.
+        """
+        lower, upper = _timestamps(lower), _timestamps(upper)
+        if lower.shape != upper.shape:
+            raise ValueError(f'The bound arrays have different shapes: {lower.shape} and {upper.shape}')
+        return PeriodBounds(lower, upper, np.broadcast_to(np.asarray(lower_inc, dtype=bool), lower.shape).copy(),
+                            np.broadcast_to(np.asarray(upper_inc, dtype=bool), lower.shape).copy())
+
+    @staticmethod
+    def from_periods(periods: Sequence[Union[Period, PeriodSet]]) -> PeriodBounds:
+        """
+        Bounds of the periods, and of the periods composing the period sets.
+        """
+        spans = []
+        for time in periods:
+            if isinstance(time, Period):
+                spans.append(time._inner)
+            elif isinstance(time, PeriodSet):
+                ps, count = periodset_periods(time._inner)
+                spans.extend(ps[i] for i in range(count))
+            else:
+                raise TypeError(f'Operation not supported with type {time.__class__}')
+        count = len(spans)
+        return PeriodBounds(np.fromiter((period_lower(p) for p in spans), dtype=np.int64, count=count),
+                            np.fromiter((period_upper(p) for p in spans), dtype=np.int64, count=count),
+                            np.fromiter((p.lower_inc for p in spans), dtype=bool, count=count),
+                            np.fromiter((p.upper_inc for p in spans), dtype=bool, count=count))
+
+    def to_periods(self) -> List[Period]:
+        return [Period(_inner=period_make(lo, up, li, ui)) for lo, up, li, ui in
+                zip(self.lower.tolist(), self.upper.tolist(), self.lower_inc.tolist(), self.upper_inc.tolist())]
+
+    def to_periodset(self) -> PeriodSet:
+        """
+        Period set of the periods, normalized by MEOS.
+        """
+        if len(self) == 0:
+            raise ValueError('Cannot build a period set without periods')
+        periods = [period._inner for period in self.to_periods()]
+        return PeriodSet(_inner=periodset_make(periods, len(periods), True))
+
+    @property
+    def start(self) -> np.ndarray:
+        return timestamptz_array_to_datetime64(self.lower)
+
+    @property
+    def end(self) -> np.ndarray:
+        return timestamptz_array_to_datetime64(self.upper)
+
+    def duration(self) -> timedelta:
+        """
+        Sum of the durations of the periods, which is the total time covered when they are disjoint.
+        """
+        return timedelta(microseconds=int((self.upper - self.lower).sum()))
+
+    def _encode(self) -> Tuple[np.ndarray, np.ndarray]:
+        # Half-open [start, end) on the doubled axis, without the empty periods
+        if len(self) and (np.abs(self.lower).max() >= _MAX_TIMESTAMP or np.abs(self.upper).max() >= _MAX_TIMESTAMP):
+            raise ValueError('Infinite or out of range period bounds are not supported')
+        start = 2 * self.lower + ~self.lower_inc
+        end = 2 * self.upper + self.upper_inc
+        valid = start < end
+        return start[valid], end[valid]
+
+    @staticmethod
+    def _decode(start: np.ndarray, end: np.ndarray) -> PeriodBounds:
+        return PeriodBounds(start >> 1, end >> 1, start & 1 == 0, end & 1 == 1)
+
+
+class PeriodSweep:
+    """
+    Set operations over large arrays of periods, computed with a sort-based sweep in ``O(n log n)`` instead of
+    folding the periods one at a time through an aggregator or :meth:`PeriodSet.union`.
+
+    The inputs are :class:`PeriodBounds`, or sequences of periods and period sets. The periods of an input may
+    overlap each other. Results are :class:`PeriodBounds` of disjoint ordered periods, which can be turned into a
+    :class:`PeriodSet` with :meth:`PeriodBounds.to_periodset`.
+
+        >>> active = PeriodSweep.union(PeriodBounds.from_arrays(trip_starts, trip_ends))
+        >>> active.duration()
+        >>> PeriodSweep.intersection(driver_shifts, vehicle_availability).to_periodset()
+    """
+
+    @staticmethod
+    def union(*inputs: Union[PeriodBounds, Sequence[Union[Period, PeriodSet]]]) -> PeriodBounds:
+        """
+        Time covered by at least one period of the inputs.
+        """
+        points, counts = PeriodSweep._sweep(inputs)
+        return PeriodSweep._select(points, (counts > 0).any(axis=0))
+
+    @staticmethod
+    def intersection(*inputs: Union[PeriodBounds, Sequence[Union[Period, PeriodSet]]]) -> PeriodBounds:
+        """
+        Time covered by every input, i.e., by at least one period of each of them.
+        """
+        points, counts = PeriodSweep._sweep(inputs)
+        return PeriodSweep._select(points, (counts > 0).all(axis=0))
+
+    @staticmethod
+    def difference(first: Union[PeriodBounds, Sequence[Union[Period, PeriodSet]]],
+                   *others: Union[PeriodBounds, Sequence[Union[Period, PeriodSet]]]) -> PeriodBounds:
+        """
+        Time covered by the first input and by none of the others.
+        """
+        points, counts = PeriodSweep._sweep((first, *others))
+        return PeriodSweep._select(points, (counts[0] > 0) & (counts[1:].sum(axis=0) == 0))
+
+    @staticmethod
+    def coverage(*inputs: Union[PeriodBounds, Sequence[Union[Period, PeriodSet]]],
+                 min_count: int = 1) -> Tuple[PeriodBounds, np.ndarray]:
+        """
+        Number of periods of the inputs covering every instant, as disjoint periods with a constant count and the
+        array of their counts. Only the periods covered at least ``min_count`` times are returned.
+        """
+        points, counts = PeriodSweep._sweep(inputs)
+        total = counts.sum(axis=0, dtype=np.int64)
+        # Consecutive elementary intervals with the same count form a single period
+        first = np.flatnonzero(np.diff(total, prepend=-1) != 0)
+        last = np.append(first[1:], len(total))
+        keep = total[first] >= max(min_count, 1)
+        return PeriodBounds._decode(points[first[keep]], points[last[keep]]), total[first[keep]]
+
+    @staticmethod
+    def _sweep(inputs) -> Tuple[np.ndarray, np.ndarray]:
+        # Distinct bound points of all the inputs and, for every input, the number of its periods covering each
+        # elementary interval between consecutive points
+        if len(inputs) == 0:
+            raise ValueError('At least one input is needed')
+        encoded = [(bounds if isinstance(bounds, PeriodBounds) else PeriodBounds.from_periods(bounds))._encode()
+                   for bounds in inputs]
+        points = np.unique(np.concatenate([np.concatenate(e) for e in encoded]))
+        counts = np.empty((len(encoded), max(len(points) - 1, 0)), dtype=np.int32)
+        for i, (start, end) in enumerate(encoded):
+            # Periods started minus periods ended at or before the start of every elementary interval
+            started = np.searchsorted(np.sort(start), points[:-1], side='right')
+            ended = np.searchsorted(np.sort(end), points[:-1], side='right')
+            counts[i] = started - ended
+        return points, counts
+
+    @staticmethod
+    def _select(points: np.ndarray, selected: np.ndarray) -> PeriodBounds:
+        # Merges the runs of consecutive selected elementary intervals into periods
+        if not selected.any():
+            return PeriodBounds._decode(np.empty(0, dtype=np.int64), np.empty(0, dtype=np.int64))
+        change = np.diff(selected.astype(np.int8), prepend=0, append=0)
+        first = np.flatnonzero(change == 1)
+        last = np.flatnonzero(change == -1)
+        return PeriodBounds._decode(points[first], points[last])
+
+
+def _timestamps(values: np.ndarray) -> np.ndarray:
+    values = np.asarray(values)
+    if np.issubdtype(values.dtype, np.datetime64):
+        return datetime64_to_timestamptz_array(values)
+    return values.astype(np.int64)
@@ -0,0 +1,131 @@
+from __future__ import annotations
+
+from dataclasses import dataclass, fields
+from functools import partial
+from typing import List, Optional, Union
+
+import numpy as np
+
+from .common import haversine
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64
+from ..main import TPoint, TGeogPoint, TFloat, TInt
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant
+
+
+@dataclass
+class QualityProfile:
+    """
+    Data-quality summary of a collection of temporal values, one entry per value in every array:
+
+    - ``count``: number of instants, ``sequences``: number of sequences.
+    - ``start``, ``end``: first and last timestamps.
+    - ``mean_interval``, ``median_interval``, ``p95_interval``: statistics of the sampling intervals in seconds,
+      without the duplicates.
+    - ``max_gap``: longest interval between consecutive instants in seconds, including the gaps between sequences.
+    - ``duplicates``: number of instants repeating the timestamp of the previous one, i.e., sequences touching
+      each other.
+    - ``zero_length``: number of intervals without movement (points) or change of value (numbers).
+    - ``max_speed``: highest speed between consecutive instants, in units of the SRID per second (meters per second
+      for geographic points), or highest absolute rate of change of the value per second for numbers.
+    - ``outliers``: number of intervals faster than the speed threshold of the profiler, 0 without threshold.
+    - ``xmin``, ``ymin``, ``xmax``, ``ymax``: spatial extent of points, or value extent of numbers in ``xmin`` and
+      ``xmax`` as in ``TBox``.
+    """
+    count: np.ndarray
+    sequences: np.ndarray
+    start: np.ndarray
+    end: np.ndarray
+    mean_interval: np.ndarray
+    median_interval: np.ndarray
+    p95_interval: np.ndarray
+    max_gap: np.ndarray
+    duplicates: np.ndarray
+    zero_length: np.ndarray
+    max_speed: np.ndarray
+    outliers: np.ndarray
+    xmin: np.ndarray
+    ymin: np.ndarray
+    xmax: np.ndarray
+    ymax: np.ndarray
+
+    def __len__(self):
+        return len(self.count)
+
+    def to_dataframe(self):
+        """
+        Summary as a ``pandas.DataFrame`` with one row per temporal value.
+        """
+        from pandas import DataFrame
+        return DataFrame({f.name: getattr(self, f.name) for f in fields(self)})
+
+
+class QualityProfiler:
+    """
+    Data-quality profiles of temporal points, floats and integers.
+
+    The timestamps and coordinates (or values) of every temporal value are extracted once as numpy arrays, and all
+    the statistics are computed from them with vectorized operations.
+
+        >>> QualityProfiler.profile_batch(trips, speed_threshold=50).to_dataframe()
+    """
+
+    @staticmethod
+    def profile(temporal: Union[TPoint, TFloat, TInt], speed_threshold: Optional[float] = None) -> QualityProfile:
+        """
+        Profile of a single temporal value.
+        """
+        return QualityProfiler._collect([QualityProfiler._row(temporal, speed_threshold)])
+
+    @staticmethod
+    def profile_batch(temporals: List[Union[TPoint, TFloat, TInt]], speed_threshold: Optional[float] = None,
+                      max_workers: Optional[int] = None) -> QualityProfile:
+        """
+        Profiles of all the temporal values, computed on a thread pool.
+        """
+        rows = parallel_map(partial(QualityProfiler._row, speed_threshold=speed_threshold), temporals, max_workers)
+        return QualityProfiler._collect(rows)
+
+    @staticmethod
+    def _row(temporal: Temporal, speed_threshold: Optional[float]) -> tuple:
+        if isinstance(temporal, TPoint):
+            t, x, y, _ = temporal.to_arrays()
+            if isinstance(temporal, TGeogPoint):
+                steps = haversine(x[:-1], y[:-1], x[1:], y[1:])
+            else:
+                steps = np.hypot(np.diff(x), np.diff(y))
+            extent = (x.min(), y.min(), x.max(), y.max())
+        elif isinstance(temporal, (TFloat, TInt)):
+            t, values = temporal.to_arrays()
+            values = values.astype(float)
+            steps = np.abs(np.diff(values))
+            extent = (values.min(), np.nan, values.max(), np.nan)
+        else:
+            raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        t = datetime64_to_timestamptz_array(t)
+        intervals = np.diff(t) / 1e6
+        positive = intervals > 0
+        # Repeated timestamps are counted as duplicates and excluded from the sampling statistics
+        sampling = intervals[positive]
+        speeds = steps[positive] / sampling
+        if len(sampling) > 0:
+            mean, median, p95 = sampling.mean(), np.median(sampling), np.percentile(sampling, 95)
+            max_gap = sampling.max()
+        else:
+            mean = median = p95 = max_gap = np.nan
+        max_speed = speeds.max() if len(speeds) > 0 else np.nan
+        outliers = int((speeds > speed_threshold).sum()) if speed_threshold is not None else 0
+        sequences = 1 if isinstance(temporal, TInstant) else temporal.num_sequences
+        return (len(t), sequences, t[0], t[-1], mean, median, p95, max_gap, int((~positive).sum()),
+                int(((steps == 0) & positive).sum()), max_speed, outliers, *extent)
+
+    @staticmethod
+    def _collect(rows: List[tuple]) -> QualityProfile:
+        names = [f.name for f in fields(QualityProfile)]
+        columns = list(zip(*rows)) if rows else [()] * len(names)
+        types = {'count': np.int64, 'sequences': np.int64, 'duplicates': np.int64, 'zero_length': np.int64,
+                 'outliers': np.int64, 'start': np.int64, 'end': np.int64}
+        arrays = {name: np.array(column, dtype=types.get(name, float)) for name, column in zip(names, columns)}
+        arrays['start'] = timestamptz_array_to_datetime64(arrays['start'])
+        arrays['end'] = timestamptz_array_to_datetime64(arrays['end'])
+        return QualityProfile(**arrays)
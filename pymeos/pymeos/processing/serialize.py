@@ -0,0 +1,175 @@
+from __future__ import annotations
+
+import json
+from contextlib import contextmanager
+from io import BytesIO
+from typing import Any, BinaryIO, Callable, Dict, Iterator, List, Optional, Sequence, Union
+
+import numpy as np
+
+from ..main import TPoint, TBool, TFloat, TInt, TText
+from ..parallel import parallel_map
+from ..temporal import Temporal
+
+FORMATS = ['wkt', 'ewkt', 'mfjson', 'geojson']
+
+
+class BulkSerializer:
+    """
+    Serialization of collections of temporal values to text formats:
+
+    - ``'wkt'``: the text representation of MEOS (``tpoint_out``, ``tfloat_out``...).
+    - ``'ewkt'``: the same, with the SRID of temporal points.
+    - ``'mfjson'``: OGC Moving Features JSON.
+    - ``'geojson'``: GeoJSON of the trajectory of temporal points.
+
+    MEOS formats the values on a thread pool. Results are taken as UTF-8 bytes straight from MEOS, without decoding
+    them into ``str`` objects, and written to files or Arrow arrays in the order of the collection. Large collections
+    are formatted and written in chunks so that only one chunk of text is held in memory.
+
+        >>> BulkSerializer.to_file(trips, 'trips.mfjson.jsonl', format='mfjson', max_workers=16)
+        >>> BulkSerializer.geojson_collection(trips, 'trips.geojson', properties={'vehicle': vehicles})
+    """
+
+    @staticmethod
+    def serialize(temporals: Sequence[Temporal], format: str = 'wkt', precision: int = 6,
+                  max_workers: Optional[int] = None, **options) -> List[bytes]:
+        """
+        UTF-8 text of every temporal value. ``options`` are passed to the MEOS function: ``with_bbox``, ``flags``
+        and ``srs`` for MF-JSON, ``option`` and ``srs`` for GeoJSON.
+        """
+        formatter = _formatter(format, precision, **options)
+        return parallel_map(formatter, temporals, max_workers)
+
+    @staticmethod
+    def to_file(temporals: Sequence[Temporal], sink: Union[str, BinaryIO], format: str = 'wkt', precision: int = 6,
+                separator: bytes = b'\n', chunksize: int = 65536, max_workers: Optional[int] = None,
+                **options) -> int:
+        """
+        Writes the text of every temporal value followed by ``separator`` (one value per line by default) to a
+        file path or a binary file object, and returns the number of bytes written.
+        """
+        formatter = _formatter(format, precision, **options)
+        with _open(sink) as file:
+            written = 0
+            for chunk in _chunks(temporals, formatter, chunksize, max_workers):
+                data = separator.join(chunk) + separator
+                file.write(data)
+                written += len(data)
+        return written
+
+    @staticmethod
+    def to_arrow(temporals: Sequence[Temporal], format: str = 'wkt', precision: int = 6,
+                 max_workers: Optional[int] = None, **options):
+        """
+        Text of every temporal value as a ``pyarrow`` large string array.
+        """
+        import pyarrow as pa
+        return pa.array(BulkSerializer.serialize(temporals, format, precision, max_workers, **options),
+                        type=pa.large_string())
+
+    @staticmethod
+    def geojson_collection(tpoints: Sequence[TPoint], sink: Optional[Union[str, BinaryIO]] = None,
+                           properties: Optional[Dict[str, Sequence[Any]]] = None, precision: int = 6,
+                           chunksize: int = 65536, max_workers: Optional[int] = None) -> Optional[str]:
+        """
+        GeoJSON FeatureCollection with a feature per temporal point, whose geometry is its trajectory and whose
+        properties are the values at its position in the ``properties`` columns. It is written to ``sink`` when
+        given, and returned as a string otherwise.
+        """
+        properties = properties or {}
+        for name, column in properties.items():
+            if len(column) != len(tpoints):
+                raise ValueError(f'Got {len(column)} values of {name} for {len(tpoints)} temporal points')
+        geometry = _formatter('geojson', precision)
+        columns = list(properties.items())
+
+        def feature(n: int) -> bytes:
+            values = json.dumps({name: column[n] for name, column in columns}, default=_json_default)
+            return b'{"type":"Feature","geometry":' + geometry(tpoints[n]) + b',"properties":' + \
+                values.encode('utf-8') + b'}'
+
+        with _open(sink) as file:
+            file.write(b'{"type":"FeatureCollection","features":[')
+            first = True
+            for chunk in _chunks(range(len(tpoints)), feature, chunksize, max_workers):
+                file.write((b'' if first else b',') + b','.join(chunk))
+                first = False
+            file.write(b']}')
+            if sink is None:
+                return file.getvalue().decode('utf-8')
+        return None
+
+
+def _lib_and_ffi():
+    from pymeos_cffi.functions import _lib, _ffi
+    return _lib, _ffi
+
+
+def _formatter(format: str, precision: int, with_bbox: bool = True, flags: int = 3, option: int = 1,
+               srs: Optional[str] = None) -> Callable[[Temporal], bytes]:
+    # Function returning the UTF-8 text of a temporal value. MEOS is called through _lib instead of the pymeos_cffi
+    # wrappers because these decode the text into str, which would then have to be encoded again to be written
+    if format not in FORMATS:
+        raise ValueError(f'Unknown format {format}, expected one of {FORMATS}')
+    lib, ffi = _lib_and_ffi()
+    srs = ffi.NULL if srs is None else ffi.new('char[]', srs.encode('utf-8'))
+
+    def text(temporal: Temporal):
+        if format == 'mfjson':
+            return lib.temporal_as_mfjson(temporal._inner, with_bbox, flags, precision, srs)
+        if isinstance(temporal, TPoint):
+            if format == 'geojson':
+                # MEOS exports no function to release its results, so the trajectory is not released, as with
+                # the results of the pymeos_cffi wrappers
+                return lib.gserialized_as_geojson(lib.tpoint_trajectory(temporal._inner), option, precision, srs)
+            if format == 'ewkt':
+                return lib.tpoint_as_ewkt(temporal._inner, precision)
+            return lib.tpoint_out(temporal._inner, precision)
+        if format == 'geojson':
+            raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        if isinstance(temporal, TFloat):
+            return lib.tfloat_out(temporal._inner, precision)
+        if isinstance(temporal, TInt):
+            return lib.tint_out(temporal._inner)
+        if isinstance(temporal, TBool):
+            return lib.tbool_out(temporal._inner)
+        if isinstance(temporal, TText):
+            return lib.ttext_out(temporal._inner)
+        raise TypeError(f'Operation not supported with type {temporal.__class__}')
+
+    def formatter(temporal: Temporal) -> bytes:
+        if not isinstance(temporal, Temporal):
+            raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        result = text(temporal)
+        if result == ffi.NULL:
+            raise ValueError(f'MEOS could not format the value as {format}')
+        return ffi.string(result)
+
+    return formatter
+
+
+def _chunks(items: Sequence, function: Callable[[Any], bytes], chunksize: int,
+            max_workers: Optional[int]) -> Iterator[List[bytes]]:
+    for start in range(0, len(items), chunksize):
+        yield parallel_map(function, items[start:start + chunksize], max_workers)
+
+
+@contextmanager
+def _open(sink: Optional[Union[str, BinaryIO]]) -> Iterator[BinaryIO]:
+    # Opens a path for writing, uses a file object as is, or writes into memory when there is no sink
+    if sink is None:
+        yield BytesIO()
+    elif isinstance(sink, str):
+        with open(sink, 'wb') as file:
+            yield file
+    else:
+        yield sink
+
+
+def _json_default(value: Any) -> Any:
+    if isinstance(value, np.generic):
+        return value.item()
+    if isinstance(value, np.ndarray):
+        return value.tolist()
+    return str(value)
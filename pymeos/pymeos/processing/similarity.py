@@ -0,0 +1,235 @@
+from __future__ import annotations
+
+import pickle
+from datetime import timedelta
+from typing import Hashable, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+from ..arrays import datetime64_to_timestamptz_array
+from ..main import TPoint
+from ..parallel import parallel_map
+from ..shared import _to_wkb, _from_wkb
+from ..temporal import TInstant, TSequence, TInterpolation
+
+METRICS = ['frechet', 'dtw']
+_MAGIC = b'PYMEOSS\x01'
+
+
+class TrajectorySimilarityIndex:
+    """
+    Approximate similarity search over large collections of temporal points.
+
+    Every trajectory is encoded as the set of space-time tiles it traverses, with tiles of ``cell_size`` units of
+    the SRID and ``duration`` (spatial tiles only without it) aligned to ``origin`` and ``torigin`` as in
+    ``stbox_tile_list``. The sets are summarized by MinHash signatures of ``num_perm`` hashes, whose agreement
+    estimates the Jaccard similarity of the sets, and split into ``bands`` bands for locality-sensitive hashing:
+    trajectories sharing all the hashes of a band with the query are candidates.
+
+    More bands (fewer hashes per band) find more candidates, raising the recall and the query time, and larger
+    signatures make the Jaccard estimates more precise. At query time, candidates are ranked by their estimate and
+    the best ``candidates`` of them are reranked with the exact Fréchet or dynamic time warping distance.
+
+        >>> index = TrajectorySimilarityIndex(cell_size=500, duration=timedelta(minutes=30))
+        >>> index.add(trips, ids=trip_ids, max_workers=16)
+        >>> ids, distances = index.query(trip, k=10, candidates=200, metric='frechet')
+        >>> index.save('trips.simidx')
+    """
+
+    def __init__(self, cell_size: float, duration: Optional[timedelta] = None, num_perm: int = 128,
+                 bands: int = 32, origin: Tuple[float, float] = (0.0, 0.0), torigin: int = 0, seed: int = 0):
+        if cell_size <= 0:
+            raise ValueError(f'The cell size must be positive, got {cell_size}')
+        if num_perm % bands != 0:
+            raise ValueError(f'The number of hashes ({num_perm}) must be a multiple of the number of bands ({bands})')
+        self.cell_size = cell_size
+        self.duration = None if duration is None else int(duration / timedelta(microseconds=1))
+        self.num_perm = num_perm
+        self.bands = bands
+        self.origin = origin
+        self.torigin = torigin
+        self.seed = seed
+        self._salts = np.random.default_rng(seed).integers(0, 2 ** 63, num_perm, dtype=np.uint64)
+        self._ids: List[Hashable] = []
+        self._trips: List[Optional[TPoint]] = []
+        self._signatures = np.empty((0, num_perm), dtype=np.uint64)
+        # Per band, the band keys of the trajectories sorted, and the positions of the trajectories in that order
+        self._keys = np.empty((bands, 0), dtype=np.uint64)
+        self._order = np.empty((bands, 0), dtype=np.int64)
+
+    def __len__(self):
+        return len(self._ids)
+
+    @property
+    def rows(self) -> int:
+        """
+        Number of hashes per band.
+        """
+        return self.num_perm // self.bands
+
+    def add(self, trips: Sequence[TPoint], ids: Optional[Sequence[Hashable]] = None, keep: bool = True,
+            max_workers: Optional[int] = None) -> None:
+        """
+        Adds the trajectories, with positions as ids by default. Their signatures are computed on a thread pool. The
+        trajectories are kept for reranking unless ``keep`` is false.
+        """
+        if ids is None:
+            ids = range(len(self._ids), len(self._ids) + len(trips))
+        if len(ids) != len(trips):
+            raise ValueError(f'Got {len(ids)} ids for {len(trips)} trajectories')
+        signatures = parallel_map(self.signature, trips, max_workers)
+        self._ids.extend(ids)
+        self._trips.extend(trips if keep else [None] * len(trips))
+        self._signatures = np.concatenate([self._signatures, np.array(signatures, dtype=np.uint64)
+                                           .reshape(-1, self.num_perm)])
+        keys = self._band_keys(self._signatures)
+        self._order = np.argsort(keys, axis=1, kind='stable')
+        self._keys = np.take_along_axis(keys, self._order, axis=1)
+
+    def cells(self, trip: TPoint) -> np.ndarray:
+        """
+        Keys of the space-time tiles traversed by the trajectory. Segments are sampled at half the size of the
+        tiles so that the tiles they cross are included.
+        """
+        if not isinstance(trip, TPoint):
+            raise TypeError(f'Operation not supported with type {trip.__class__}')
+        pieces = [trip] if isinstance(trip, (TInstant, TSequence)) else trip.sequences
+        keys = [self._piece_cells(piece) for piece in pieces]
+        return np.unique(np.concatenate(keys))
+
+    def signature(self, trip: TPoint) -> np.ndarray:
+        """
+        MinHash signature of the tiles of the trajectory.
+        """
+        cells = self.cells(trip)
+        return _mix(cells[None, :] ^ self._salts[:, None]).min(axis=1)
+
+    def candidates(self, trip: TPoint, limit: Optional[int] = None,
+                   min_similarity: float = 0.0) -> Tuple[List[Hashable], np.ndarray]:
+        """
+        Ids of the trajectories sharing at least one band with the query and their estimated Jaccard similarity,
+        from the most similar, keeping at most ``limit`` of them above ``min_similarity``.
+        """
+        positions, similarity = self._candidates(self.signature(trip), limit, min_similarity)
+        return [self._ids[p] for p in positions], similarity
+
+    def query(self, trip: TPoint, k: int = 10, candidates: int = 100, metric: Optional[str] = 'frechet',
+              min_similarity: float = 0.0, max_workers: Optional[int] = None) -> Tuple[List[Hashable], np.ndarray]:
+        """
+        Ids of the ``k`` trajectories most similar to the query among the best ``candidates`` candidates, with
+        their exact distance (``'frechet'`` or ``'dtw'``) in increasing order, or with their estimated Jaccard
+        similarity in decreasing order when ``metric`` is ``None``.
+        """
+        if metric is not None and metric not in METRICS:
+            raise ValueError(f'Unknown metric {metric}, expected one of {METRICS}')
+        positions, similarity = self._candidates(self.signature(trip), candidates, min_similarity)
+        if metric is None:
+            return [self._ids[p] for p in positions[:k]], similarity[:k]
+        if any(self._trips[p] is None for p in positions):
+            raise ValueError('The trajectories were not kept in the index, they cannot be reranked')
+
+        def distance(position: int) -> float:
+            other = self._trips[position]
+            return trip.frechet_distance(other) if metric == 'frechet' else trip.dyntimewarp_distance(other)
+
+        distances = np.array(parallel_map(distance, positions.tolist(), max_workers), dtype=float)
+        order = np.argsort(distances, kind='stable')[:k]
+        return [self._ids[positions[o]] for o in order], distances[order]
+
+    def query_batch(self, trips: Sequence[TPoint], k: int = 10, candidates: int = 100,
+                    metric: Optional[str] = 'frechet', min_similarity: float = 0.0,
+                    max_workers: Optional[int] = None) -> List[Tuple[List[Hashable], np.ndarray]]:
+        """
+        Results of :meth:`query` for every trajectory, computed on a thread pool.
+        """
+        return parallel_map(lambda trip: self.query(trip, k, candidates, metric, min_similarity, 1), trips,
+                            max_workers)
+
+    def save(self, path: str) -> None:
+        """
+        Writes the index, with the kept trajectories as extended WKB, so that loading it does not recompute the
+        signatures.
+        """
+        snapshot = {
+            'parameters': (self.cell_size, self.duration, self.num_perm, self.bands, self.origin, self.torigin,
+                           self.seed),
+            'ids': self._ids,
+            'trips': [None if t is None else _to_wkb(t) for t in self._trips],
+            'signatures': self._signatures,
+            'keys': self._keys,
+            'order': self._order,
+        }
+        with open(path, 'wb') as file:
+            file.write(_MAGIC)
+            pickle.dump(snapshot, file, protocol=pickle.HIGHEST_PROTOCOL)
+
+    @staticmethod
+    def load(path: str) -> TrajectorySimilarityIndex:
+        """
+        Reads an index written by :meth:`save`. Indexes are pickles, so only load trusted files.
+        """
+        with open(path, 'rb') as file:
+            if file.read(len(_MAGIC)) != _MAGIC:
+                raise ValueError(f'{path} is not a trajectory similarity index')
+            snapshot = pickle.load(file)
+        cell_size, duration, num_perm, bands, origin, torigin, seed = snapshot['parameters']
+        index = TrajectorySimilarityIndex(cell_size, None if duration is None else timedelta(microseconds=duration),
+                                          num_perm, bands, origin, torigin, seed)
+        index._ids = snapshot['ids']
+        index._trips = [None if w is None else _from_wkb(w) for w in snapshot['trips']]
+        index._signatures = snapshot['signatures']
+        index._keys = snapshot['keys']
+        index._order = snapshot['order']
+        return index
+
+    def _piece_cells(self, piece: TPoint) -> np.ndarray:
+        t, x, y, _ = piece.to_arrays()
+        t = datetime64_to_timestamptz_array(t)
+        if len(t) > 1 and piece.interpolation != TInterpolation.DISCRETE:
+            # Number of samples of every segment, enough to visit every tile it crosses
+            steps = np.ceil(np.hypot(np.diff(x), np.diff(y)) / (self.cell_size / 2))
+            if self.duration is not None:
+                steps = np.maximum(steps, np.ceil(np.diff(t) / (self.duration / 2)))
+            steps = np.maximum(steps, 1).astype(np.int64)
+            segment = np.repeat(np.arange(len(steps)), steps)
+            fraction = (np.arange(len(segment)) - np.repeat(np.cumsum(steps) - steps, steps)) / steps[segment]
+            if piece.interpolation == TInterpolation.STEPWISE:
+                fraction = np.zeros_like(fraction)
+            x = np.append(x[segment] + fraction * (x[segment + 1] - x[segment]), x[-1])
+            y = np.append(y[segment] + fraction * (y[segment + 1] - y[segment]), y[-1])
+            t = np.append(t[segment] + (fraction * (t[segment + 1] - t[segment])).astype(np.int64), t[-1])
+        column = np.floor((x - self.origin[0]) / self.cell_size).astype(np.int64)
+        row = np.floor((y - self.origin[1]) / self.cell_size).astype(np.int64)
+        tile = np.zeros_like(column) if self.duration is None else (t - self.torigin) // self.duration
+        return _mix(_mix(_mix(column.astype(np.uint64)) ^ row.astype(np.uint64)) ^ tile.astype(np.uint64))
+
+    def _band_keys(self, signatures: np.ndarray) -> np.ndarray:
+        # One key per band and trajectory, combining the hashes of the band
+        bands = signatures.reshape(len(signatures), self.bands, self.rows)
+        keys = np.zeros((len(signatures), self.bands), dtype=np.uint64)
+        for row in range(self.rows):
+            keys = _mix(keys ^ bands[:, :, row])
+        return keys.T.copy()
+
+    def _candidates(self, signature: np.ndarray, limit: Optional[int],
+                    min_similarity: float) -> Tuple[np.ndarray, np.ndarray]:
+        keys = self._band_keys(signature[None, :])[:, 0]
+        found = []
+        for band in range(self.bands):
+            lo = np.searchsorted(self._keys[band], keys[band], side='left')
+            hi = np.searchsorted(self._keys[band], keys[band], side='right')
+            found.append(self._order[band, lo:hi])
+        positions = np.unique(np.concatenate(found)) if found else np.empty(0, dtype=np.int64)
+        similarity = (self._signatures[positions] == signature).mean(axis=1)
+        order = np.argsort(-similarity, kind='stable')
+        order = order[similarity[order] >= min_similarity][:limit]
+        return positions[order], similarity[order]
+
+
+def _mix(values: np.ndarray) -> np.ndarray:
+    # SplitMix64 finalizer, a fast bijective mixing of 64-bit keys
+    with np.errstate(over='ignore'):
+        values = values.astype(np.uint64)
+        values = (values ^ (values >> np.uint64(30))) * np.uint64(0xBF58476D1CE4E5B9)
+        values = (values ^ (values >> np.uint64(27))) * np.uint64(0x94D049BB133111EB)
+        return values ^ (values >> np.uint64(31))
@@ -0,0 +1,188 @@
+from __future__ import annotations
+
+from functools import partial
+from typing import Callable, List, Optional, TypeVar
+
+import numpy as np
+
+from .common import sequence_arrays, rebuild_sequence
+from ..main import TPoint, TFloat
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant, TSequence
+
+TG = TypeVar('TG', bound=Temporal)
+
+# A kernel receives the elapsed seconds of the instants of a sequence and an (n, d) array of values (coordinates
+# for points) and returns the smoothed (n, d) array.
+Kernel = Callable[[np.ndarray, np.ndarray], np.ndarray]
+
+
+class TemporalSmoother:
+    """
+    Noise filters for temporal points and temporal floats.
+
+    Every sequence is filtered independently on the numpy arrays of its instants and rebuilt with the same
+    timestamps, bounds and interpolation. Instants are returned unchanged. Geographic points are filtered on
+    their longitude and latitude.
+    """
+
+    @staticmethod
+    def kalman(temporal: TG, process_noise: float = 1.0, measurement_noise: float = 1.0, smooth: bool = True) -> TG:
+        """
+        Constant-velocity Kalman filter on irregular timestamps.
+
+        Args:
+            temporal: temporal point or float to filter.
+            process_noise: spectral density of the acceleration noise (units² / s³).
+            measurement_noise: variance of the measurement noise (units²).
+            smooth: whether to run the Rauch-Tung-Striebel backward pass after the forward filter.
+        """
+        kernel = partial(TemporalSmoother._kalman_kernel, process_noise=process_noise,
+                         measurement_noise=measurement_noise, smooth=smooth)
+        return TemporalSmoother._apply(temporal, kernel)
+
+    @staticmethod
+    def savitzky_golay(temporal: TG, window: int = 5, order: int = 2) -> TG:
+        """
+        Savitzky-Golay filter: every instant is replaced by the value at its timestamp of the least-squares
+        polynomial of degree ``order`` fitted on the ``window`` instants centered on it, using the actual
+        (possibly irregular) timestamps. The window must be odd.
+        """
+        if window % 2 == 0:
+            raise ValueError(f'The window must be odd, got {window}')
+        if window <= order:
+            raise ValueError(f'The window ({window}) must be greater than the polynomial order ({order})')
+        kernel = partial(TemporalSmoother._savitzky_golay_kernel, window=window, order=order)
+        return TemporalSmoother._apply(temporal, kernel)
+
+    @staticmethod
+    def median(temporal: TG, window: int = 5) -> TG:
+        """
+        Rolling median over the ``window`` instants centered on every instant, which must be odd. Points use the
+        coordinate-wise median.
+        """
+        if window < 1 or window % 2 == 0:
+            raise ValueError(f'The window must be positive and odd, got {window}')
+        kernel = partial(TemporalSmoother._median_kernel, window=window)
+        return TemporalSmoother._apply(temporal, kernel)
+
+    @staticmethod
+    def batch(temporals: List[TG], method: str = 'kalman', max_workers: Optional[int] = None, **kwargs) -> List[TG]:
+        """
+        Applies the filter ``method`` (``'kalman'``, ``'savitzky_golay'`` or ``'median'``) with the given
+        parameters to every temporal value on a thread pool.
+        """
+        methods = {
+            'kalman': TemporalSmoother.kalman,
+            'savitzky_golay': TemporalSmoother.savitzky_golay,
+            'median': TemporalSmoother.median,
+        }
+        if method not in methods:
+            raise ValueError(f'Unknown smoothing method {method}. Valid methods are: {", ".join(methods)}')
+        return parallel_map(partial(methods[method], **kwargs), temporals, max_workers)
+
+    @staticmethod
+    def _apply(temporal: TG, kernel: Kernel) -> TG:
+        if not isinstance(temporal, (TPoint, TFloat)):
+            raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        if isinstance(temporal, TInstant):
+            return temporal
+        sequences = [TemporalSmoother._apply_sequence(seq, kernel) for seq in temporal.sequences]
+        if isinstance(temporal, TSequence):
+            return sequences[0]
+        return temporal.__class__(sequence_list=sequences, normalize=False)
+
+    @staticmethod
+    def _apply_sequence(sequence: TSequence, kernel: Kernel) -> TSequence:
+        t, values = sequence_arrays(sequence)
+        seconds = (t - t[0]) / np.timedelta64(1, 's')
+        return rebuild_sequence(sequence, t, kernel(seconds, values))
+
+    @staticmethod
+    def _kalman_kernel(seconds: np.ndarray, values: np.ndarray, process_noise: float, measurement_noise: float,
+                       smooth: bool) -> np.ndarray:
+        n = len(seconds)
+        q = process_noise
+        r = measurement_noise
+        # The covariance does not depend on the measurements, so it is shared by all the dimensions and only the
+        # position and velocity states are vectors.
+        pos = np.empty_like(values)
+        vel = np.empty_like(values)
+        pred_pos = np.empty_like(values)
+        pred_vel = np.empty_like(values)
+        covs = np.empty((n, 3))
+        pred_covs = np.empty((n, 3))
+        # Diffuse prior on the velocity
+        p00, p01, p11 = r, 0.0, 1e6
+        pos[0] = values[0]
+        vel[0] = 0.0
+        covs[0] = pred_covs[0] = (p00, p01, p11)
+        pred_pos[0] = pos[0]
+        pred_vel[0] = vel[0]
+        for k in range(1, n):
+            dt = seconds[k] - seconds[k - 1]
+            # Predict
+            pred_pos[k] = pos[k - 1] + dt * vel[k - 1]
+            pred_vel[k] = vel[k - 1]
+            a = p00 + 2 * dt * p01 + dt * dt * p11 + q * dt ** 3 / 3
+            b = p01 + dt * p11 + q * dt * dt / 2
+            c = p11 + q * dt
+            pred_covs[k] = (a, b, c)
+            # Update
+            s = a + r
+            k0 = a / s
+            k1 = b / s
+            innovation = values[k] - pred_pos[k]
+            pos[k] = pred_pos[k] + k0 * innovation
+            vel[k] = pred_vel[k] + k1 * innovation
+            p00, p01, p11 = (1 - k0) * a, (1 - k0) * b, c - k1 * b
+            covs[k] = (p00, p01, p11)
+        if not smooth:
+            return pos
+        # Rauch-Tung-Striebel backward pass
+        for k in range(n - 2, -1, -1):
+            dt = seconds[k + 1] - seconds[k]
+            p00, p01, p11 = covs[k]
+            a, b, c = pred_covs[k + 1]
+            det = a * c - b * b
+            if det <= 0:
+                continue
+            # C = P_k F^T P_{k+1|k}^-1
+            f00, f01, f10, f11 = p00 + dt * p01, p01, p01 + dt * p11, p11
+            c00 = (f00 * c - f01 * b) / det
+            c01 = (f01 * a - f00 * b) / det
+            c10 = (f10 * c - f11 * b) / det
+            c11 = (f11 * a - f10 * b) / det
+            d_pos = pos[k + 1] - pred_pos[k + 1]
+            d_vel = vel[k + 1] - pred_vel[k + 1]
+            pos[k] = pos[k] + c00 * d_pos + c01 * d_vel
+            vel[k] = vel[k] + c10 * d_pos + c11 * d_vel
+        return pos
+
+    @staticmethod
+    def _savitzky_golay_kernel(seconds: np.ndarray, values: np.ndarray, window: int, order: int) -> np.ndarray:
+        n = len(seconds)
+        half = window // 2
+        result = np.empty_like(values)
+        for i in range(n):
+            lo, hi = max(0, i - half), min(n, i + half + 1)
+            offsets = seconds[lo:hi] - seconds[i]
+            scale = np.abs(offsets).max()
+            if scale == 0:
+                result[i] = values[i]
+                continue
+            degree = min(order, hi - lo - 1)
+            # Offsets are scaled to [-1, 1] to keep the Vandermonde matrix well conditioned
+            vander = np.vander(offsets / scale, degree + 1, increasing=True)
+            coefficients = np.linalg.lstsq(vander, values[lo:hi], rcond=None)[0]
+            result[i] = coefficients[0]
+        return result
+
+    @staticmethod
+    def _median_kernel(seconds: np.ndarray, values: np.ndarray, window: int) -> np.ndarray:
+        n = len(seconds)
+        half = window // 2
+        result = np.empty_like(values)
+        for i in range(n):
+            result[i] = np.median(values[max(0, i - half):min(n, i + half + 1)], axis=0)
+        return result
@@ -0,0 +1,218 @@
+from __future__ import annotations
+
+from dataclasses import dataclass
+from datetime import datetime, timedelta
+from typing import Hashable, Iterator, Optional, Sequence, Tuple, Union
+
+import numpy as np
+
+from .common import sequence_arrays
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64, to_timestamptz_list
+from ..main import TPoint, TFloat, TInt
+from ..temporal import Temporal, TInstant, TInterpolation
+from ..time import Period
+
+
+@dataclass
+class Snapshot:
+    """
+    Values of the objects defined at one timestamp. ``values`` has one row per object: the X, Y (and Z)
+    coordinates of temporal points or the value of temporal numbers.
+    """
+    timestamp: np.datetime64
+    ids: np.ndarray
+    values: np.ndarray
+
+    @property
+    def x(self) -> np.ndarray:
+        return self.values[:, 0]
+
+    @property
+    def y(self) -> np.ndarray:
+        return self.values[:, 1]
+
+    @property
+    def z(self) -> Optional[np.ndarray]:
+        return self.values[:, 2] if self.values.shape[1] > 2 else None
+
+    @property
+    def value(self) -> np.ndarray:
+        return self.values[:, 0]
+
+
+@dataclass
+class SnapshotFrames:
+    """
+    Snapshots at several timestamps in long form: row ``i`` holds the values of object ``ids[i]`` at
+    ``timestamps[frame[i]]``. Rows are ordered by frame and, within a frame, in the order of the index.
+    """
+    timestamps: np.ndarray
+    frame: np.ndarray
+    ids: np.ndarray
+    values: np.ndarray
+
+    def __len__(self):
+        return len(self.timestamps)
+
+    def __getitem__(self, n: int) -> Snapshot:
+        lo, hi = np.searchsorted(self.frame, [n, n + 1])
+        return Snapshot(self.timestamps[n], self.ids[lo:hi], self.values[lo:hi])
+
+    def __iter__(self) -> Iterator[Snapshot]:
+        return (self[n] for n in range(len(self)))
+
+
+class _Track:
+    """
+    Instants of one object as arrays, with the piece (sequence) of every instant and whether each instant is
+    included in its sequence, i.e., it is not an exclusive bound.
+    """
+    __slots__ = ['t', 'values', 'piece', 'included', 'interpolation']
+
+    def __init__(self, temporal: Temporal):
+        ts, values, pieces, included = [], [], [], []
+        sequences = [temporal] if isinstance(temporal, TInstant) else temporal.sequences
+        for n, sequence in enumerate(sequences):
+            t, v = sequence_arrays(sequence)
+            inc = np.ones(len(t), dtype=bool)
+            if len(t) > 1:
+                inc[0] = sequence.lower_inc
+                inc[-1] = sequence.upper_inc
+            ts.append(datetime64_to_timestamptz_array(t))
+            values.append(v.astype(float))
+            pieces.append(np.full(len(t), n))
+            included.append(inc)
+        self.t = np.concatenate(ts)
+        self.values = np.concatenate(values)
+        self.piece = np.concatenate(pieces)
+        self.included = np.concatenate(included)
+        self.interpolation = temporal.interpolation
+
+    def at(self, timestamps: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Mask of the (sorted) timestamps where the object is defined and its values at them.
+        """
+        t = self.t
+        n = len(t)
+        i = np.searchsorted(t, timestamps, side='right') - 1
+        valid = i >= 0
+        i = np.maximum(i, 0)
+        exact = valid & (t[i] == timestamps)
+        # The instant at i may be the excluded lower bound of a sequence starting where the previous one ends
+        previous = np.maximum(i - 1, 0)
+        use_previous = exact & ~self.included[i] & (i > 0) & (t[previous] == timestamps) & self.included[previous]
+        i = np.where(use_previous, previous, i)
+        exact &= self.included[i]
+        result = self.values[i].copy()
+        if self.interpolation == TInterpolation.DISCRETE or n == 1:
+            return exact, result
+        following = np.minimum(i + 1, n - 1)
+        inside = valid & ~exact & (i + 1 < n) & (self.piece[i] == self.piece[following]) & (t[i] < timestamps)
+        if self.interpolation == TInterpolation.LINEAR:
+            span = (t[following] - t[i]).astype(float)
+            ratio = np.divide((timestamps - t[i]).astype(float), span, out=np.zeros(len(i)), where=span > 0)
+            result = np.where(inside[:, None],
+                              self.values[i] + (self.values[following] - self.values[i]) * ratio[:, None], result)
+        return exact | inside, result
+
+
+class SnapshotIndex:
+    """
+    Index over a collection of temporal points or numbers answering "where is every object at time t" queries.
+
+    The instants of every object are extracted once into numpy arrays. A snapshot then finds the candidate objects
+    from their periods, binary searches the timestamps in their instants and interpolates between the bracketing
+    instants according to the interpolation of the object, without calling MEOS. Geographic points are
+    interpolated linearly on their longitude and latitude.
+
+        >>> index = SnapshotIndex(trips, ids=vessel_ids)
+        >>> frames = index.at_grid(period, step=timedelta(seconds=10))
+        >>> for frame in frames:
+        ...     scatter.set_offsets(np.column_stack([frame.x, frame.y]))
+    """
+
+    def __init__(self, temporals: Sequence[Temporal], ids: Optional[Sequence[Hashable]] = None):
+        temporals = list(temporals)
+        for temporal in temporals:
+            if not isinstance(temporal, (TPoint, TFloat, TInt)):
+                raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        self.ids = np.asarray(ids if ids is not None else np.arange(len(temporals)))
+        if len(self.ids) != len(temporals):
+            raise ValueError(f'Got {len(self.ids)} ids for {len(temporals)} temporal values')
+        self._tracks = [_Track(temporal) for temporal in temporals]
+        dimensions = {track.values.shape[1] for track in self._tracks}
+        if len(dimensions) > 1:
+            raise ValueError('All the temporal values must have the same number of dimensions')
+        self._dimensions = dimensions.pop() if dimensions else 1
+        starts = np.array([track.t[0] for track in self._tracks], dtype=np.int64)
+        self._ends = np.array([track.t[-1] for track in self._tracks], dtype=np.int64)
+        self._order = np.argsort(starts, kind='stable')
+        self._sorted_starts = starts[self._order]
+
+    def __len__(self):
+        return len(self._tracks)
+
+    def _candidates(self, first: int, last: int) -> np.ndarray:
+        # Objects whose period intersects [first, last], in index order
+        started = self._order[:np.searchsorted(self._sorted_starts, last, side='right')]
+        return np.sort(started[self._ends[started] >= first])
+
+    def at(self, timestamp: Union[datetime, str, np.datetime64]) -> Snapshot:
+        """
+        Values of the objects defined at ``timestamp``.
+        """
+        return self.at_timestamps([timestamp])[0]
+
+    def at_grid(self, start: Union[Period, datetime, str], end: Optional[Union[datetime, str]] = None,
+                step: Union[timedelta, str] = timedelta(seconds=1)) -> SnapshotFrames:
+        """
+        Snapshots at a regular grid of timestamps from ``start`` to ``end`` (both included), or over a period.
+        """
+        if isinstance(start, Period):
+            start, end = start.lower, start.upper
+        if end is None:
+            raise ValueError('The end of the grid is required when the start is not a period')
+        first, last = to_timestamptz_list([start, end])
+        step_us = int(_to_timedelta(step) / timedelta(microseconds=1))
+        if step_us <= 0:
+            raise ValueError(f'The step must be positive, got {step}')
+        return self._frames(np.arange(first, last + 1, step_us, dtype=np.int64))
+
+    def at_timestamps(self, timestamps: Union[np.ndarray, Sequence[Union[datetime, str]]]) -> SnapshotFrames:
+        """
+        Snapshots at the given timestamps, which are sorted.
+        """
+        if isinstance(timestamps, np.ndarray) and not np.issubdtype(timestamps.dtype, np.datetime64):
+            raise TypeError('Timestamp arrays must have a datetime64 type')
+        return self._frames(np.sort(np.asarray(to_timestamptz_list(timestamps), dtype=np.int64)))
+
+    def _frames(self, timestamps: np.ndarray) -> SnapshotFrames:
+        frames, ids, values = [], [], []
+        if len(timestamps) > 0:
+            for k in self._candidates(timestamps[0], timestamps[-1]):
+                track = self._tracks[k]
+                lo = np.searchsorted(timestamps, track.t[0], side='left')
+                hi = np.searchsorted(timestamps, track.t[-1], side='right')
+                defined, result = track.at(timestamps[lo:hi])
+                rows = np.flatnonzero(defined)
+                frames.append(rows + lo)
+                ids.append(np.full(len(rows), k))
+                values.append(result[rows])
+        if frames:
+            frame = np.concatenate(frames)
+            objects = np.concatenate(ids)
+            vals = np.concatenate(values)
+            order = np.lexsort((objects, frame))
+            frame, objects, vals = frame[order], objects[order], vals[order]
+        else:
+            frame = np.empty(0, dtype=np.int64)
+            objects = np.empty(0, dtype=np.int64)
+            vals = np.empty((0, self._dimensions))
+        return SnapshotFrames(timestamptz_array_to_datetime64(timestamps), frame, self.ids[objects], vals)
+
+
+def _to_timedelta(step: Union[timedelta, str]) -> timedelta:
+    if isinstance(step, timedelta):
+        return step
+    from pandas import Timedelta
+    return Timedelta(step).to_pytimedelta()
@@ -0,0 +1,317 @@
+from __future__ import annotations
+
+from dataclasses import dataclass, field
+from datetime import datetime, timedelta
+from typing import Dict, Hashable, List, Optional, Sequence, Set, Tuple, Union
+
+import numpy as np
+import shapely
+from pymeos_cffi import gserialized_in, tintersects_tpoint_geo, tdwithin_tpoint_tpoint
+
+from .nearest import _to_shapely
+from ..arrays import temporal_instant_timestamps, tbool_instant_values, timestamptz_array_to_datetime64, \
+    to_timestamptz_list
+from ..main import TPointSeq
+from ..temporal import TInterpolation
+
+
+@dataclass
+class StreamEvent:
+    """
+    Change of the state of a standing query at time ``t``:
+
+    - geofences: ``'enter'`` or ``'exit'`` of the object ``id``.
+    - proximity: ``'near'`` or ``'far'`` between the objects ``id`` and ``other``.
+    - speed: ``'above'`` or ``'below'`` the threshold for the object ``id``.
+    """
+    t: np.datetime64
+    query: str
+    kind: str
+    id: Hashable
+    other: Optional[Hashable] = None
+
+
+class _Segment:
+    # Movement of an object between two consecutive fixes, as a linear MEOS sequence built on demand
+    __slots__ = ('id', 't0', 't1', 'p0', 'p1', 'srid', '_sequence')
+
+    def __init__(self, id: Hashable, t0: int, t1: int, p0: Tuple[float, float], p1: Tuple[float, float],
+                 srid: int):
+        self.id = id
+        self.t0, self.t1 = t0, t1
+        self.p0, self.p1 = p0, p1
+        self.srid = srid
+        self._sequence = None
+
+    @property
+    def line(self) -> shapely.LineString:
+        return shapely.linestrings([self.p0, self.p1])
+
+    @property
+    def sequence(self) -> TPointSeq:
+        if self._sequence is None:
+            self._sequence = TPointSeq.from_arrays([self.t0, self.t1], [self.p0[0], self.p1[0]],
+                                                   [self.p0[1], self.p1[1]], srid=self.srid, lower_inc=True,
+                                                   upper_inc=True, interpolation=TInterpolation.LINEAR)
+        return self._sequence
+
+
+@dataclass
+class _ObjectState:
+    # Last fix, last segment and the queries whose condition holds for the object
+    t: int
+    position: Tuple[float, float]
+    segment: Optional[_Segment] = None
+    inside: Set[str] = field(default_factory=set)
+    speeding: Set[str] = field(default_factory=set)
+
+
+class ContinuousQueryEngine:
+    """
+    Incremental evaluation of standing queries over streams of positions.
+
+    Fixes are appended in batches. Every new fix of an object forms a linear segment with its previous fix, and only
+    these segments are evaluated, against the queries they can affect:
+
+    - geofences (:meth:`add_geofence`): the zones intersecting the segment, found with an STRtree, and the zones the
+      object is in, with MEOS ``tintersects`` on the segment.
+    - proximity (:meth:`add_proximity`): the segments of other objects overlapping the segment in time and within
+      the distance in space, and the segments of the objects already near, with MEOS ``tdwithin`` on the pair of
+      segments.
+    - speed (:meth:`add_speed`): the speed along the segment.
+
+    The state kept per object is its last fix, its last segment and the queries it satisfies, plus the pairs of
+    objects currently near, so memory does not grow with the length of the streams. Coordinates are planar, in the
+    units of ``srid``. Fixes that are not after the last fix of their object are dropped and counted in ``late``.
+    When two fixes are more than ``max_gap`` apart, the object is considered gone at the first one (every condition
+    ends) and reappearing at the second one.
+
+        >>> engine = ContinuousQueryEngine(srid=3857, max_gap=timedelta(minutes=5))
+        >>> engine.add_geofence('port', port_polygon)
+        >>> engine.add_proximity('collision', 50)
+        >>> events = engine.append(ids, t, x, y)
+    """
+
+    def __init__(self, srid: int = 0, max_gap: Optional[timedelta] = None):
+        self.srid = srid
+        self.max_gap = None if max_gap is None else int(max_gap / timedelta(microseconds=1))
+        self.late = 0
+        self._zone_names: List[str] = []
+        self._zones: List[shapely.Geometry] = []
+        self._zone_gs = []
+        self._zone_tree: Optional[shapely.STRtree] = None
+        self._proximity: Dict[str, float] = {}
+        self._speed: Dict[str, float] = {}
+        self._objects: Dict[Hashable, _ObjectState] = {}
+        self._near: Dict[str, Set[frozenset]] = {}
+
+    def add_geofence(self, name: str, zone) -> None:
+        """
+        Registers a geofence query on ``zone`` (shapely or postgis polygon), emitting ``'enter'`` and ``'exit'``
+        events. Objects already tracked are evaluated from their next segment.
+        """
+        self._check_name(name)
+        geometry = _to_shapely(zone)
+        self._zone_names.append(name)
+        self._zones.append(geometry)
+        self._zone_gs.append(gserialized_in(shapely.to_wkb(shapely.set_srid(geometry, self.srid), hex=True,
+                                                          include_srid=True), -1))
+        self._zone_tree = shapely.STRtree(self._zones)
+
+    def add_proximity(self, name: str, distance: float) -> None:
+        """
+        Registers a proximity query emitting ``'near'`` and ``'far'`` events when two objects get within
+        ``distance`` of each other and apart again.
+        """
+        self._check_name(name)
+        if distance < 0:
+            raise ValueError(f'The distance must not be negative, got {distance}')
+        self._proximity[name] = distance
+        self._near[name] = set()
+
+    def add_speed(self, name: str, threshold: float) -> None:
+        """
+        Registers a speed query emitting ``'above'`` and ``'below'`` events when the speed of an object (units of
+        the SRID per second) between two fixes crosses ``threshold``.
+        """
+        self._check_name(name)
+        self._speed[name] = threshold
+
+    def remove(self, name: str) -> None:
+        """
+        Unregisters the query ``name``, dropping its state without emitting events.
+        """
+        if name in self._zone_names:
+            n = self._zone_names.index(name)
+            del self._zone_names[n], self._zones[n], self._zone_gs[n]
+            self._zone_tree = shapely.STRtree(self._zones) if self._zones else None
+            for state in self._objects.values():
+                state.inside.discard(name)
+        elif name in self._proximity:
+            del self._proximity[name], self._near[name]
+        elif name in self._speed:
+            del self._speed[name]
+            for state in self._objects.values():
+                state.speeding.discard(name)
+        else:
+            raise KeyError(name)
+
+    def __len__(self):
+        return len(self._objects)
+
+    def append(self, ids: Sequence[Hashable], t: Union[np.ndarray, Sequence[Union[datetime, str, int]]],
+               x: Sequence[float], y: Sequence[float]) -> List[StreamEvent]:
+        """
+        Appends a batch of fixes, in any order, and returns the events they trigger in temporal order.
+        """
+        t = np.asarray(to_timestamptz_list(t), dtype=np.int64)
+        x, y = np.asarray(x, dtype=float), np.asarray(y, dtype=float)
+        if not len(ids) == len(t) == len(x) == len(y):
+            raise ValueError('The identifiers, timestamps and coordinates must have the same length')
+        events = []
+        segments: List[_Segment] = []
+        # Segments of the objects before the batch, and instants where objects disappeared, for proximity
+        previous: Dict[Hashable, Optional[_Segment]] = {}
+        gaps: List[Tuple[int, Hashable]] = []
+        for k in np.argsort(t, kind='stable'):
+            oid, tk, position = ids[k], int(t[k]), (float(x[k]), float(y[k]))
+            state = self._objects.get(oid)
+            if state is None:
+                state = self._objects[oid] = _ObjectState(tk, position)
+                events.extend(self._fix_events(oid, state))
+                continue
+            if tk <= state.t:
+                self.late += 1
+                continue
+            previous.setdefault(oid, state.segment)
+            if self.max_gap is not None and tk - state.t > self.max_gap:
+                events.extend(self._close(oid, state))
+                gaps.append((state.t, oid))
+                self._objects[oid] = state = _ObjectState(tk, position)
+                events.extend(self._fix_events(oid, state))
+                continue
+            segment = _Segment(oid, state.t, tk, state.position, position, self.srid)
+            segments.append(segment)
+            events.extend(self._segment_events(segment, state))
+            state.t, state.position, state.segment = tk, position, segment
+        for name, distance in self._proximity.items():
+            events.extend(self._proximity_events(name, distance, segments, previous, gaps))
+        events.sort(key=lambda e: e[0])
+        times = timestamptz_array_to_datetime64([e[0] for e in events])
+        return [StreamEvent(ti, *e[1:]) for ti, e in zip(times, events)]
+
+    def expire(self, before: Union[datetime, str]) -> int:
+        """
+        Stops tracking the objects whose last fix is before ``before``, without emitting events, and returns their
+        number.
+        """
+        limit = to_timestamptz_list([before])[0]
+        expired = {oid for oid, state in self._objects.items() if state.t < limit}
+        for oid in expired:
+            del self._objects[oid]
+        for near in self._near.values():
+            near.difference_update({pair for pair in near if pair & expired})
+        return len(expired)
+
+    def _check_name(self, name: str) -> None:
+        if name in self._zone_names or name in self._proximity or name in self._speed:
+            raise ValueError(f'A query named {name} is already registered')
+
+    def _fix_events(self, oid: Hashable, state: _ObjectState) -> List[tuple]:
+        # Zones containing the first fix of an object
+        if self._zone_tree is None:
+            return []
+        zones = self._zone_tree.query(shapely.points(*state.position), predicate='intersects')
+        state.inside = {self._zone_names[z] for z in zones}
+        return [(state.t, name, 'enter', oid, None) for name in state.inside]
+
+    def _close(self, oid: Hashable, state: _ObjectState) -> List[tuple]:
+        # Ends the conditions of an object at its last fix
+        events = [(state.t, name, 'exit', oid, None) for name in state.inside]
+        events += [(state.t, name, 'below', oid, None) for name in state.speeding]
+        return events
+
+    def _segment_events(self, segment: _Segment, state: _ObjectState) -> List[tuple]:
+        events = []
+        if self._zone_tree is not None:
+            zones = set(self._zone_tree.query(segment.line, predicate='intersects').tolist())
+            zones.update(self._zone_names.index(name) for name in state.inside)
+            for z in sorted(zones):
+                name = self._zone_names[z]
+                result = tintersects_tpoint_geo(segment.sequence._inner, self._zone_gs[z], False, False)
+                for ti, inside in _changes(result, name in state.inside):
+                    (state.inside.add if inside else state.inside.discard)(name)
+                    events.append((ti, name, 'enter' if inside else 'exit', segment.id, None))
+        if self._speed:
+            speed = np.hypot(segment.p1[0] - segment.p0[0], segment.p1[1] - segment.p0[1]) / \
+                ((segment.t1 - segment.t0) / 1e6)
+            for name, threshold in self._speed.items():
+                above = speed > threshold
+                if above != (name in state.speeding):
+                    (state.speeding.add if above else state.speeding.discard)(name)
+                    events.append((segment.t0, name, 'above' if above else 'below', segment.id, None))
+        return events
+
+    def _proximity_events(self, name: str, distance: float, segments: List[_Segment],
+                          previous: Dict[Hashable, Optional[_Segment]], gaps: List[Tuple[int, Hashable]]) \
+            -> List[tuple]:
+        near = self._near[name]
+        moved = {oid for _, oid in gaps} | {s.id for s in segments}
+        samples: Dict[frozenset, List[Tuple[int, bool]]] = {}
+        for ti, oid in gaps:
+            for pair in near:
+                if oid in pair:
+                    samples.setdefault(pair, []).append((ti, False))
+        if segments:
+            # Segments of the batch followed by the last segments before the batch that may overlap them in time
+            start = min(s.t0 for s in segments)
+            batch = {id(s) for s in segments}
+            old = [previous.get(oid, state.segment) for oid, state in self._objects.items()]
+            candidates = segments + [s for s in old if s is not None and id(s) not in batch and s.t1 > start]
+            n = len(segments)
+            tree = shapely.STRtree([s.line for s in candidates])
+            new, other = tree.query([s.line for s in segments], predicate='dwithin', distance=distance)
+            pairs = {(i, j) for i, j in zip(new.tolist(), other.tolist()) if j >= n or i < j}
+            # Pairs already near are evaluated even when their segments are far apart, to detect the end
+            by_object: Dict[Hashable, List[int]] = {}
+            for i, s in enumerate(candidates):
+                by_object.setdefault(s.id, []).append(i)
+            for pair in near:
+                if not pair & moved:
+                    continue
+                a, b = tuple(pair)
+                for i in by_object.get(a, []):
+                    for j in by_object.get(b, []):
+                        if i < n or j < n:
+                            pairs.add((min(i, j), max(i, j)))
+            for i, j in pairs:
+                s, r = candidates[i], candidates[j]
+                if s.id == r.id or s.t1 < r.t0 or r.t1 < s.t0:
+                    continue
+                result = tdwithin_tpoint_tpoint(s.sequence._inner, r.sequence._inner, distance, False, False)
+                if result is not None:
+                    ts, values = temporal_instant_timestamps(result), tbool_instant_values(result)
+                    samples.setdefault(frozenset((s.id, r.id)), []).extend(zip(ts.tolist(), values.tolist()))
+        events = []
+        for pair, values in samples.items():
+            values.sort(key=lambda sample: sample[0])
+            current = pair in near
+            a, b = tuple(pair)
+            for ti, value in values:
+                if value != current:
+                    current = value
+                    events.append((ti, name, 'near' if value else 'far', a, b))
+            (near.add if current else near.discard)(pair)
+        return events
+
+
+def _changes(result, current: bool) -> List[Tuple[int, bool]]:
+    # Instants where a temporal boolean differs from the current state, with the new state
+    if result is None:
+        return []
+    changes = []
+    for ti, value in zip(temporal_instant_timestamps(result).tolist(), tbool_instant_values(result).tolist()):
+        if value != current:
+            current = value
+            changes.append((ti, value))
+    return changes
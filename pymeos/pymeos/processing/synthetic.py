@@ -0,0 +1,312 @@
+from __future__ import annotations
+
+from dataclasses import dataclass
+from datetime import timedelta
+from typing import BinaryIO, Iterator, List, Optional, Tuple, Union
+
+import numpy as np
+
+from pymeos_cffi import stbox_tmin, stbox_tmax, tpointseq_make_coords, tsequenceset_make
+
+from ..arrays import timestamptz_array_to_datetime64
+from ..boxes import STBox
+from ..main import TPoint
+from ..parallel import parallel_map
+from ..shared import _to_wkb, _from_wkb
+from ..temporal import Temporal, TInterpolation
+
+MOTIONS = ['random_walk', 'waypoint']
+# Objects are generated in blocks with their own random stream, so that the output for a seed does not depend on the
+# size of the batches requested
+_BLOCK = 1024
+
+
+@dataclass
+class SyntheticPoints:
+    """
+    Columnar positions of a batch of synthetic objects, ordered by object and time. ``offsets`` holds the index of
+    the first point of every object followed by the number of points, and ``sequence`` the index of the sequence
+    of every point within its object, which increases after every gap.
+    """
+    id: np.ndarray
+    t: np.ndarray
+    x: np.ndarray
+    y: np.ndarray
+    sequence: np.ndarray
+    offsets: np.ndarray
+    srid: int = 0
+
+    def __len__(self):
+        return len(self.t)
+
+    @property
+    def timestamps(self) -> np.ndarray:
+        return timestamptz_array_to_datetime64(self.t)
+
+    def temporals(self, max_workers: Optional[int] = None) -> List[TPoint]:
+        """
+        Temporal point of every object, a sequence set when it has gaps.
+        """
+        return parallel_map(self._temporal, range(len(self.offsets) - 1), max_workers)
+
+    def _temporal(self, n: int) -> TPoint:
+        start, end = self.offsets[n], self.offsets[n + 1]
+        sequence = self.sequence[start:end]
+        bounds = np.flatnonzero(np.diff(sequence, prepend=-1, append=-1) != 0)
+        pieces = [tpointseq_make_coords(self.x[lo:hi].tolist(), self.y[lo:hi].tolist(), None,
+                                        self.t[lo:hi].tolist(), int(hi - lo), self.srid, False, True, True,
+                                        TInterpolation.LINEAR, True)
+                  for lo, hi in zip(start + bounds[:-1], start + bounds[1:])]
+        if len(pieces) == 1:
+            return Temporal._factory(pieces[0])
+        return Temporal._factory(tsequenceset_make(pieces, len(pieces), True))
+
+    def to_arrow(self):
+        """
+        ``pyarrow.Table`` with one row per point: ``id``, ``sequence``, ``t`` as UTC timestamps, ``x`` and ``y``.
+        """
+        import pyarrow as pa
+        return pa.table({
+            'id': pa.array(self.id),
+            'sequence': pa.array(self.sequence),
+            't': pa.array(self.timestamps, type=pa.timestamp('us', tz='UTC')),
+            'x': pa.array(self.x),
+            'y': pa.array(self.y),
+        })
+
+
+class TrajectoryGenerator:
+    """
+    Deterministic generator of synthetic trajectories for benchmarks and scaling tests.
+
+    Every object moves within the spatial extent of ``extent`` during ``duration`` (the whole period of the box by
+    default, otherwise starting at a random time within it), sampled every ``sampling`` with a relative ``jitter``:
+
+    - ``'random_walk'``: the heading changes by a normal angle of standard deviation ``turn`` radians at every
+      sample, and the object bounces off the borders of the box.
+    - ``'waypoint'``: the object travels in straight lines between random waypoints of the box.
+
+    Speeds are drawn per object between ``speed[0]`` and ``speed[1]`` units of the SRID per second. Gaussian
+    ``noise`` is added to the positions and reflected at the borders of the box, and every sample starts with
+    probability ``gap_probability`` a gap of ``gap_length`` missing samples on average, which splits the trajectory
+    into several sequences.
+
+    Positions are computed with vectorized numpy operations over blocks of objects, each with its own random stream
+    derived from the seed, so the same seed always produces the same objects whatever the batch size.
+
+        >>> generator = TrajectoryGenerator(STBox('STBOX XT(((0,0),(10000,10000)),[2023-01-01, 2023-01-02])'),
+        ...                                 objects=10000, sampling=timedelta(seconds=5), seed=42)
+        >>> generator.write_parquet('synthetic.parquet')
+        >>> trips = generator.temporals()
+    """
+
+    def __init__(self, extent: STBox, objects: int, sampling: timedelta = timedelta(seconds=10),
+                 duration: Optional[timedelta] = None, motion: str = 'random_walk',
+                 speed: Tuple[float, float] = (1.0, 10.0), turn: float = 0.2, noise: float = 0.0,
+                 gap_probability: float = 0.0, gap_length: float = 10.0, jitter: float = 0.0, seed: int = 0):
+        if motion not in MOTIONS:
+            raise ValueError(f'Unknown motion {motion}, expected one of {MOTIONS}')
+        if not extent.has_xy or not extent.has_t:
+            raise ValueError('The extent must have spatial and temporal dimensions')
+        if not 0 <= jitter < 1:
+            raise ValueError(f'The jitter must be in [0, 1), got {jitter}')
+        self.xmin, self.ymin, self.xmax, self.ymax = extent.xmin, extent.ymin, extent.xmax, extent.ymax
+        self.tmin, self.tmax = stbox_tmin(extent._inner), stbox_tmax(extent._inner)
+        self.srid = extent.srid
+        self.objects = objects
+        self.sampling = int(sampling / timedelta(microseconds=1))
+        self.duration = self.tmax - self.tmin if duration is None else int(duration / timedelta(microseconds=1))
+        if self.sampling <= 0 or self.duration > self.tmax - self.tmin:
+            raise ValueError('The sampling must be positive and the duration must fit in the extent')
+        self.samples = self.duration // self.sampling + 1
+        self.motion = motion
+        self.speed = speed
+        self.turn = turn
+        self.noise = noise
+        self.gap_probability = gap_probability
+        self.gap_length = gap_length
+        self.jitter = jitter
+        self.seed = seed
+
+    @property
+    def points(self) -> int:
+        """
+        Number of samples before removing the gaps.
+        """
+        return self.objects * self.samples
+
+    def batches(self, objects: int = 65536, max_workers: Optional[int] = None) -> Iterator[SyntheticPoints]:
+        """
+        Points of the objects in batches of about ``objects`` objects, rounded to the internal block size. The
+        blocks of a batch are generated on a thread pool.
+        """
+        step = max(1, objects // _BLOCK)
+        blocks = range(0, -(-self.objects // _BLOCK))
+        for first in range(0, len(blocks), step):
+            yield _concatenate(parallel_map(self._block, blocks[first:first + step], max_workers), self.srid)
+
+    def arrays(self, max_workers: Optional[int] = None) -> SyntheticPoints:
+        """
+        Points of all the objects.
+        """
+        return _concatenate(list(self.batches(self.objects, max_workers)), self.srid)
+
+    def temporals(self, max_workers: Optional[int] = None) -> List[TPoint]:
+        """
+        Temporal points of all the objects.
+        """
+        return [temporal for batch in self.batches() for temporal in batch.temporals(max_workers)]
+
+    def write_parquet(self, path: str, objects: int = 65536) -> int:
+        """
+        Writes the points as in :meth:`SyntheticPoints.to_arrow` to a Parquet file, one row group per batch, and
+        returns the number of points.
+        """
+        import pyarrow.parquet as pq
+        written = 0
+        writer = None
+        try:
+            for batch in self.batches(objects):
+                table = batch.to_arrow()
+                if writer is None:
+                    writer = pq.ParquetWriter(path, table.schema)
+                writer.write_table(table)
+                written += len(batch)
+        finally:
+            if writer is not None:
+                writer.close()
+        return written
+
+    def write_wkb(self, sink: Union[str, BinaryIO], max_workers: Optional[int] = None) -> int:
+        """
+        Writes the temporal point of every object as extended WKB, which keeps the SRID, prefixed by its size as an
+        8-byte little-endian integer, and returns the number of objects. The file is read back with
+        :meth:`read_wkb`.
+        """
+        file = open(sink, 'wb') if isinstance(sink, str) else sink
+        written = 0
+        try:
+            for batch in self.batches():
+                for record in parallel_map(_wkb_record, batch.temporals(max_workers), max_workers):
+                    file.write(record)
+                    written += 1
+        finally:
+            if isinstance(sink, str):
+                file.close()
+        return written
+
+    @staticmethod
+    def read_wkb(source: Union[str, BinaryIO]) -> Iterator[Temporal]:
+        """
+        Temporal values of a file written by :meth:`write_wkb`.
+        """
+        file = open(source, 'rb') if isinstance(source, str) else source
+        try:
+            header = file.read(8)
+            while header:
+                wkb = file.read(int.from_bytes(header, 'little'))
+                yield _from_wkb(wkb)
+                header = file.read(8)
+        finally:
+            if isinstance(source, str):
+                file.close()
+
+    def _block(self, block: int) -> SyntheticPoints:
+        rng = np.random.default_rng([self.seed, block])
+        first = block * _BLOCK
+        count = min(_BLOCK, self.objects - first)
+        n = self.samples
+
+        start = self.tmin + (rng.integers(0, self.tmax - self.tmin - self.duration + 1, count)
+                             if self.duration < self.tmax - self.tmin else np.zeros(count, dtype=np.int64))
+        offset = np.arange(n, dtype=np.float64) + rng.uniform(-self.jitter / 2, self.jitter / 2, (count, n))
+        offset[:, 0] = np.maximum(offset[:, 0], 0)
+        offset[:, -1] = np.minimum(offset[:, -1], n - 1)
+        t = start[:, None] + np.round(offset * self.sampling).astype(np.int64)
+        seconds = np.diff(t, axis=1) / 1e6
+        speed = rng.uniform(self.speed[0], self.speed[1], count)
+        if self.motion == 'random_walk':
+            x, y = self._random_walk(rng, count, n, speed, seconds)
+        else:
+            x, y = self._waypoint(rng, count, speed, t)
+        if self.noise > 0:
+            # Noisy positions are folded back into the box so that they stay within the extent
+            x = _reflect(x + rng.normal(0, self.noise, x.shape), self.xmin, self.xmax)
+            y = _reflect(y + rng.normal(0, self.noise, y.shape), self.ymin, self.ymax)
+
+        keep, sequence = self._gaps(rng, count, n)
+        ids = np.repeat(np.arange(first, first + count, dtype=np.int64), n)
+        offsets = np.append(0, np.cumsum(keep.sum(axis=1)))
+        keep = keep.reshape(-1)
+        return SyntheticPoints(ids[keep], t.reshape(-1)[keep], x.reshape(-1)[keep], y.reshape(-1)[keep],
+                               sequence.reshape(-1)[keep], offsets, self.srid)
+
+    def _random_walk(self, rng: np.random.Generator, count: int, n: int, speed: np.ndarray,
+                     seconds: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        heading = rng.uniform(0, 2 * np.pi, (count, 1)) + \
+            np.cumsum(rng.normal(0, self.turn, (count, n - 1)), axis=1)
+        step = speed[:, None] * seconds
+        x = rng.uniform(self.xmin, self.xmax, (count, 1)) + \
+            np.concatenate([np.zeros((count, 1)), np.cumsum(step * np.cos(heading), axis=1)], axis=1)
+        y = rng.uniform(self.ymin, self.ymax, (count, 1)) + \
+            np.concatenate([np.zeros((count, 1)), np.cumsum(step * np.sin(heading), axis=1)], axis=1)
+        return _reflect(x, self.xmin, self.xmax), _reflect(y, self.ymin, self.ymax)
+
+    def _waypoint(self, rng: np.random.Generator, count: int, speed: np.ndarray,
+                  t: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        distance = speed[:, None] * (t - t[:, :1]) / 1e6
+        x = np.empty(t.shape)
+        y = np.empty(t.shape)
+        # Enough waypoints on average to cover the distance travelled, completed when the legs are too short
+        legs = int(np.ceil(distance[:, -1].max() / (0.5 * max(self.xmax - self.xmin, self.ymax - self.ymin, 1e-9))))
+        for i in range(count):
+            wx = rng.uniform(self.xmin, self.xmax, legs + 2)
+            wy = rng.uniform(self.ymin, self.ymax, legs + 2)
+            travelled = np.append(0, np.cumsum(np.hypot(np.diff(wx), np.diff(wy))))
+            while travelled[-1] < distance[i, -1]:
+                wx = np.append(wx, rng.uniform(self.xmin, self.xmax, legs + 1))
+                wy = np.append(wy, rng.uniform(self.ymin, self.ymax, legs + 1))
+                travelled = np.append(0, np.cumsum(np.hypot(np.diff(wx), np.diff(wy))))
+            x[i] = np.interp(distance[i], travelled, wx)
+            y[i] = np.interp(distance[i], travelled, wy)
+        return x, y
+
+    def _gaps(self, rng: np.random.Generator, count: int, n: int) -> Tuple[np.ndarray, np.ndarray]:
+        # Samples kept and index of their sequence, with runs of dropped samples starting at random positions
+        if self.gap_probability <= 0:
+            return np.ones((count, n), dtype=bool), np.zeros((count, n), dtype=np.int32)
+        starts = rng.random((count, n)) < self.gap_probability
+        starts[:, 0] = False
+        lengths = rng.geometric(1 / max(self.gap_length, 1), (count, n))
+        rows, columns = np.nonzero(starts)
+        delta = np.zeros((count, n + 1), dtype=np.int32)
+        np.add.at(delta, (rows, columns), 1)
+        np.add.at(delta, (rows, np.minimum(columns + lengths[rows, columns], n)), -1)
+        keep = np.cumsum(delta[:, :-1], axis=1) == 0
+        # Keep the last sample so that every object has at least one point
+        keep[:, -1] |= ~keep.any(axis=1)
+        resumed = keep & ~np.concatenate([np.ones((count, 1), dtype=bool), keep[:, :-1]], axis=1)
+        return keep, np.cumsum(resumed, axis=1, dtype=np.int32)
+
+
+def _reflect(values: np.ndarray, low: float, high: float) -> np.ndarray:
+    # Folds the coordinates into [low, high] as if the objects bounced off the borders
+    width = high - low
+    if width <= 0:
+        return np.full(values.shape, low)
+    folded = np.mod(values - low, 2 * width)
+    return low + np.where(folded > width, 2 * width - folded, folded)
+
+
+def _concatenate(blocks: List[SyntheticPoints], srid: int) -> SyntheticPoints:
+    offsets = [blocks[0].offsets] if blocks else [np.zeros(1, dtype=np.int64)]
+    for block in blocks[1:]:
+        offsets.append(block.offsets[1:] + offsets[-1][-1])
+    return SyntheticPoints(*(np.concatenate([getattr(block, name) for block in blocks])
+                             if blocks else np.empty(0) for name in ('id', 't', 'x', 'y', 'sequence')),
+                           np.concatenate(offsets), srid)
+
+
+def _wkb_record(temporal: Temporal) -> bytes:
+    wkb = _to_wkb(temporal)
+    return len(wkb).to_bytes(8, 'little') + wkb
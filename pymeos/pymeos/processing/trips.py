@@ -0,0 +1,127 @@
+from __future__ import annotations
+
+from dataclasses import dataclass
+from datetime import datetime
+from functools import partial
+from typing import Any, BinaryIO, Dict, List, Optional, Tuple, Union
+
+import numpy as np
+
+from ..arrays import datetime64_to_timestamptz_array, timestamptz_array_to_datetime64, to_timestamptz_list
+from ..main import TPoint
+from ..parallel import parallel_map
+from ..temporal import TSequenceSet
+
+
+@dataclass
+class TripBuffers:
+    """
+    Collection of trips as flat columnar buffers, the layout of trips layers in web maps (deck.gl, kepler.gl).
+
+    Path ``i`` is made of the rows ``start_indices[i]:start_indices[i + 1]`` of ``positions`` (longitude,
+    latitude and optionally altitude) and ``timestamps`` (seconds since ``epoch``), and belongs to the trip
+    ``trip[i]`` of the exported collection.
+    """
+    positions: np.ndarray
+    timestamps: np.ndarray
+    start_indices: np.ndarray
+    trip: np.ndarray
+    epoch: np.datetime64
+
+    def __len__(self):
+        return len(self.start_indices) - 1
+
+    def to_deck(self) -> Dict[str, Any]:
+        """
+        Binary data of a deck.gl ``TripsLayer``, to be serialized with the numpy arrays as typed arrays. The layer
+        must be created with ``_pathType: 'open'``.
+        """
+        return {
+            'length': len(self),
+            'startIndices': self.start_indices[:-1],
+            'attributes': {
+                'getPath': {'value': self.positions.reshape(-1), 'size': self.positions.shape[1]},
+                'getTimestamps': {'value': self.timestamps, 'size': 1},
+            },
+        }
+
+    def to_arrow(self):
+        """
+        ``pyarrow.Table`` with one row per path: the ``trip``, the ``path`` as a list of coordinate tuples and the
+        ``timestamps``. The lists share the buffers of the arrays, and the epoch is stored in the schema metadata.
+        """
+        import pyarrow as pa
+        size = self.positions.shape[1]
+        list_array = pa.LargeListArray if self.start_indices[-1] > np.iinfo(np.int32).max else pa.ListArray
+        offsets = pa.array(self.start_indices, type=pa.int64() if list_array is pa.LargeListArray else pa.int32())
+        coordinates = pa.FixedSizeListArray.from_arrays(pa.array(self.positions.reshape(-1)), size)
+        table = pa.table({
+            'trip': pa.array(self.trip),
+            'path': list_array.from_arrays(offsets, coordinates),
+            'timestamps': list_array.from_arrays(offsets, pa.array(self.timestamps)),
+        })
+        return table.replace_schema_metadata({'epoch': str(self.epoch)})
+
+    def write_arrow(self, sink: Union[str, BinaryIO]) -> None:
+        """
+        Writes the table of :meth:`to_arrow` in the Arrow IPC file format.
+        """
+        import pyarrow as pa
+        table = self.to_arrow()
+        with pa.ipc.new_file(sink, table.schema) as writer:
+            writer.write_table(table)
+
+
+class TripsExport:
+    """
+    Export of collections of temporal points for trips layers.
+
+    Coordinates and timestamps are read from MEOS as numpy arrays, without building a geometry or a ``datetime``
+    per instant, and concatenated into the buffers of a :class:`TripBuffers`. Points must be in longitude and
+    latitude, e.g. geographic points or geometric points with SRID 4326.
+    """
+
+    @staticmethod
+    def buffers(trips: List[TPoint], epoch: Optional[Union[datetime, str]] = None, split_sequences: bool = False,
+                dtype=np.float32, max_workers: Optional[int] = None) -> TripBuffers:
+        """
+        Buffers of the trips.
+
+        Args:
+            trips: temporal points.
+            epoch: origin of the timestamps, the earliest instant of the trips by default so that they fit in
+                single precision.
+            split_sequences: whether the sequences of sequence sets are exported as separate paths, instead of
+                joining them across the gaps.
+            dtype: type of the positions and timestamps. Web clients expect ``float32``.
+            max_workers: threads used to extract the arrays.
+        """
+        for trip in trips:
+            if not isinstance(trip, TPoint):
+                raise TypeError(f'Operation not supported with type {trip.__class__}')
+        if len({trip.hasz for trip in trips}) > 1:
+            raise ValueError('The trips must all have the same dimensions, either 2D or 3D')
+        arrays = parallel_map(partial(TripsExport._trip_arrays, split_sequences=split_sequences), trips, max_workers)
+        if not arrays:
+            origin = 0 if epoch is None else to_timestamptz_list([epoch])[0]
+            return TripBuffers(np.empty((0, 2), dtype=dtype), np.empty(0, dtype=dtype), np.zeros(1, dtype=np.int64),
+                               np.empty(0, dtype=np.int64), timestamptz_array_to_datetime64([origin])[0])
+        t = np.concatenate([a[0] for a in arrays])
+        positions = np.concatenate([a[1] for a in arrays])
+        lengths = np.concatenate([a[2] for a in arrays])
+        trip = np.concatenate([np.full(len(a[2]), n, dtype=np.int64) for n, a in enumerate(arrays)])
+        origin = t.min() if epoch is None else to_timestamptz_list([epoch])[0]
+        timestamps = ((t - origin) / 1e6).astype(dtype)
+        start_indices = np.concatenate([[0], np.cumsum(lengths)]).astype(np.int64)
+        return TripBuffers(positions.astype(dtype), timestamps, start_indices, trip,
+                           timestamptz_array_to_datetime64([origin])[0])
+
+    @staticmethod
+    def _trip_arrays(trip: TPoint, split_sequences: bool) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+        # MEOS timestamps, positions and number of instants of every path of the trip
+        sequences = trip.sequences if split_sequences and isinstance(trip, TSequenceSet) else [trip]
+        arrays = [sequence.to_arrays() for sequence in sequences]
+        t = np.concatenate([a[0] for a in arrays])
+        positions = np.vstack([np.column_stack([x, y] if z is None else [x, y, z]) for _, x, y, z in arrays])
+        lengths = np.array([len(a[0]) for a in arrays], dtype=np.int64)
+        return datetime64_to_timestamptz_array(t), positions, lengths
@@ -0,0 +1,217 @@
+from __future__ import annotations
+
+from typing import Any, Dict, Hashable, Iterable, List, Optional, Sequence, Tuple, Union
+
+import numpy as np
+
+from pymeos_cffi import temporal_instants, temporal_sequences, temporal_eq, temporal_copy, tsequence_make, \
+    tsequenceset_make
+
+from ..main import TPoint, TFloat
+from ..parallel import parallel_map
+from ..temporal import Temporal, TInstant, TSequence, TSequenceSet, TInterpolation
+
+Late = Union[Temporal, Sequence[TInstant]]
+
+
+class BatchUpsert:
+    """
+    Merges batches of late or corrected instants into temporal values in a single pass.
+
+    Calling :meth:`Temporal.insert` or :meth:`Temporal.update` once per late instant rebuilds the whole sequence every
+    time, so merging ``m`` instants into a value with ``n`` instants costs ``O(n·m)``. Here the batch is sorted once
+    and merged with the instants of the value in one linear pass, for ``O(n + m log m)``, and the result is built
+    with a single MEOS call.
+
+    The semantics follow ``temporal_insert`` and ``temporal_update`` for a batch of instants:
+
+    - An instant at the timestamp of an existing one must have the same value on insert, and replaces it on update.
+    - Instants falling within the period of a sequence are merged into it, making its bound inclusive when they lie
+      on an exclusive bound.
+    - With ``connect``, instants falling in a gap between sequences connect them into a single sequence, and
+      instants before the start or after the end extend the first or last sequence. Without it, the consecutive
+      late instants of each gap become a new sequence of their own.
+
+    Discrete sequences simply receive the new instants. Sequence sets stay sequence sets, while sequences and
+    instants become sequence sets only when the result is not connected.
+
+        >>> BatchUpsert.update(trip, late_instants)
+        >>> corrected = BatchUpsert.update_batch(trips, [(vessel, instant) for vessel, instant in messages])
+    """
+
+    @staticmethod
+    def insert(temporal: Optional[Temporal], late: Late, connect: bool = True, normalize: bool = True) -> Temporal:
+        """
+        Inserts the late instants, raising a ``ValueError`` when one contradicts the value at its timestamp.
+        """
+        return _merge(temporal, late, False, connect, normalize)
+
+    @staticmethod
+    def update(temporal: Optional[Temporal], late: Late, connect: bool = True, normalize: bool = True) -> Temporal:
+        """
+        Inserts the late instants, replacing the existing instants at the same timestamps. When a batch contains
+        several instants at the same timestamp, the last one wins.
+        """
+        return _merge(temporal, late, True, connect, normalize)
+
+    @staticmethod
+    def insert_batch(temporals: Dict[Hashable, Temporal],
+                     late: Union[Dict[Hashable, Late], Iterable[Tuple[Hashable, TInstant]]], connect: bool = True,
+                     normalize: bool = True, max_workers: Optional[int] = None) -> Dict[Hashable, Temporal]:
+        """
+        Inserts the late instants of every id, given as a dictionary or as ``(id, instant)`` pairs, into the value
+        with that id. Values without late instants are returned as they are, and ids without a value get a new one
+        built from their late instants. The values are merged on a thread pool.
+        """
+        return _merge_batch(temporals, late, False, connect, normalize, max_workers)
+
+    @staticmethod
+    def update_batch(temporals: Dict[Hashable, Temporal],
+                     late: Union[Dict[Hashable, Late], Iterable[Tuple[Hashable, TInstant]]], connect: bool = True,
+                     normalize: bool = True, max_workers: Optional[int] = None) -> Dict[Hashable, Temporal]:
+        """
+        Updates the value of every id with its late instants, as :meth:`insert_batch` does for insertions.
+        """
+        return _merge_batch(temporals, late, True, connect, normalize, max_workers)
+
+
+def _merge_batch(temporals: Dict[Hashable, Temporal], late: Union[Dict[Hashable, Late], Iterable[Tuple[Any, Any]]],
+                 update: bool, connect: bool, normalize: bool, max_workers: Optional[int]) -> Dict[Hashable, Temporal]:
+    if not isinstance(late, dict):
+        groups: Dict[Hashable, List[TInstant]] = {}
+        for key, instant in late:
+            groups.setdefault(key, []).append(instant)
+        late = groups
+    keys = list(late.keys())
+    merged = parallel_map(lambda key: _merge(temporals.get(key), late[key], update, connect, normalize), keys,
+                          max_workers)
+    result = dict(temporals)
+    result.update(zip(keys, merged))
+    return result
+
+
+def _merge(temporal: Optional[Temporal], late: Late, update: bool, connect: bool, normalize: bool) -> Temporal:
+    instants, times = _late_instants(temporal, late, update)
+    if temporal is None:
+        if len(instants) == 0:
+            raise ValueError('Cannot build a temporal value without instants')
+        temporal = Temporal._factory(temporal_copy(instants[0]))
+        instants, times = instants[1:], times[1:]
+    if len(instants) == 0:
+        return temporal
+
+    if isinstance(temporal, TSequence) and temporal.interpolation == TInterpolation.DISCRETE:
+        inst, count = temporal_instants(temporal._inner)
+        merged = _merge_instants([inst[i] for i in range(count)], instants, times, update)
+        return Temporal._factory(tsequence_make(merged, len(merged), True, True, TInterpolation.DISCRETE.value,
+                                                normalize))
+
+    # The owners of the instants of the pieces must stay alive until the result is built
+    pieces, owners = _pieces(temporal)
+    interpolation = temporal.interpolation if not isinstance(temporal, TInstant) else \
+        TInterpolation.LINEAR if isinstance(temporal, (TFloat, TPoint)) else TInterpolation.STEPWISE
+
+    # Distribute the sorted late instants over the pieces and the gaps around them in one pass
+    result: List[list] = []
+    n = 0
+    for piece_instants, lower_inc, upper_inc in pieces:
+        start, end = piece_instants[0].t, piece_instants[-1].t
+        gap_end = n
+        while gap_end < len(times) and times[gap_end] < start:
+            gap_end += 1
+        inside_end = gap_end
+        while inside_end < len(times) and times[inside_end] <= end:
+            inside_end += 1
+        if inside_end > gap_end:
+            lower_inc = lower_inc or times[gap_end] == start
+            upper_inc = upper_inc or times[inside_end - 1] == end
+            piece_instants = _merge_instants(piece_instants, instants[gap_end:inside_end], times[gap_end:inside_end],
+                                             update)
+        gap = instants[n:gap_end]
+        if connect and gap and result:
+            # The gap instants connect the previous piece with this one
+            previous = result.pop()
+            piece = [previous[0] + gap + piece_instants, previous[1], upper_inc]
+        elif connect and gap:
+            piece = [gap + piece_instants, True, upper_inc]
+        else:
+            if gap:
+                result.append([gap, True, True])
+            piece = [piece_instants, lower_inc, upper_inc]
+        result.append(piece)
+        n = inside_end
+    if n < len(instants):
+        if connect:
+            result[-1][0] = result[-1][0] + instants[n:]
+            result[-1][2] = True
+        else:
+            result.append([instants[n:], True, True])
+
+    sequences = [tsequence_make(piece, len(piece), lower_inc, upper_inc, interpolation.value, normalize)
+                 for piece, lower_inc, upper_inc in result]
+    if len(sequences) == 1 and not isinstance(temporal, TSequenceSet):
+        return Temporal._factory(sequences[0])
+    return Temporal._factory(tsequenceset_make(sequences, len(sequences), normalize))
+
+
+def _late_instants(temporal: Optional[Temporal], late: Late, update: bool) -> Tuple[list, np.ndarray]:
+    # Late instants sorted by timestamp, with the repeated timestamps resolved in their order of arrival
+    if isinstance(late, Temporal):
+        inst, count = temporal_instants(late._inner)
+        instants = [inst[i] for i in range(count)]
+    else:
+        for instant in late:
+            if not isinstance(instant, TInstant):
+                raise TypeError(f'Operation not supported with type {instant.__class__}')
+        instants = [instant._inner for instant in late]
+    reference = temporal._inner if temporal is not None else instants[0] if instants else None
+    for instant in instants:
+        if instant.temptype != reference.temptype:
+            raise TypeError('The late instants must have the same temporal type as the value')
+    times = np.fromiter((instant.t for instant in instants), dtype=np.int64, count=len(instants))
+    order = np.argsort(times, kind='stable')
+    instants, times = [instants[i] for i in order], times[order]
+    unique = np.ones(len(times), dtype=bool)
+    unique[:-1] = times[1:] != times[:-1]
+    for i in np.flatnonzero(~unique):
+        if not update and not temporal_eq(instants[i], instants[i + 1]):
+            raise ValueError(f'The late instants at {times[i]} have different values')
+        if not update:
+            # Keep the first instant, which is compared with the following ones
+            instants[i + 1] = instants[i]
+    return [instant for instant, keep in zip(instants, unique) if keep], times[unique]
+
+
+def _pieces(temporal: Temporal) -> Tuple[List[tuple], Any]:
+    # Instants and bounds of every sequence, with the MEOS values owning the instants to keep them alive
+    if isinstance(temporal, TInstant):
+        return [([temporal._inner], True, True)], None
+    if isinstance(temporal, TSequence):
+        sequences, count = [temporal._inner], 1
+    else:
+        sequences, count = temporal_sequences(temporal._inner)
+    pieces = []
+    for i in range(count):
+        inst, n = temporal_instants(sequences[i])
+        pieces.append(([inst[j] for j in range(n)], sequences[i].period.lower_inc, sequences[i].period.upper_inc))
+    return pieces, sequences
+
+
+def _merge_instants(existing: list, instants: list, times: np.ndarray, update: bool) -> list:
+    # Merges two sorted lists of instants, resolving equal timestamps as temporal_insert or temporal_update
+    merged = []
+    i = j = 0
+    while i < len(existing) or j < len(instants):
+        if j == len(instants) or (i < len(existing) and existing[i].t < times[j]):
+            merged.append(existing[i])
+            i += 1
+            continue
+        if i < len(existing) and existing[i].t == times[j]:
+            if not update and not temporal_eq(existing[i], instants[j]):
+                raise ValueError(f'The late instant at {times[j]} contradicts the value at that timestamp')
+            merged.append(instants[j] if update else existing[i])
+            i += 1
+        else:
+            merged.append(instants[j])
+        j += 1
+    return merged
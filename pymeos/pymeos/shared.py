@@ -0,0 +1,244 @@
+"""
+Collections of temporal values stored once in shared memory and read by worker processes without pickling.
+
+    >>> with SharedTemporalCollection.create(trips) as shared:
+    ...     lengths = shared.map(trip_length, max_workers=32)
+
+The collection is serialized into a ``multiprocessing.shared_memory`` block made of a header, the offsets of the
+records and the records. Two record formats are supported:
+
+- ``'raw'``: the memory image of the MEOS values, which are flat varlena structures. Reading a record wraps the
+  shared bytes without copying nor parsing them, so the returned value is only valid while the collection is open
+  and must not be modified in place.
+- ``'wkb'``: the MEOS WKB of the values, parsed straight from the shared memory when read. Reading allocates a new
+  MEOS value, which stays valid after the collection is closed.
+
+Pickling a collection only transfers the name of the block, so collections can be passed to any
+``ProcessPoolExecutor`` task, and workers attach to the block instead of receiving the values.
+"""
+from __future__ import annotations
+
+import sys
+from concurrent.futures import ProcessPoolExecutor
+from typing import Callable, Iterator, List, Optional, Sequence, TypeVar, Union, TYPE_CHECKING
+
+import numpy as np
+from pymeos_cffi import temporal_as_wkb, temporal_from_wkb
+
+from .temporal import Temporal
+
+if TYPE_CHECKING:
+    from multiprocessing import shared_memory
+
+R = TypeVar('R')
+
+_MAGIC = b'PYMEOS\x01\x00'
+_FORMATS = ['wkb', 'raw']
+# Magic, format and number of records, followed by the offsets of the records and of the end of the data
+_HEADER_WORDS = 3
+# Records are aligned so that raw MEOS values can be used in place
+_ALIGNMENT = 8
+# Extended WKB variant, which keeps the SRID of temporal points
+_WKB_EXTENDED = 0x04
+
+
+class SharedTemporalCollection:
+    """
+    Read-only sequence of temporal values stored in shared memory. Create it with :meth:`create` in the parent
+    process and use it (or attach to it by name with :meth:`attach`) in the workers. The creator must call
+    :meth:`unlink` (or use the collection as a context manager) to release the block. Shared memory needs Python 3.8
+    or later.
+    """
+
+    def __init__(self, memory: shared_memory.SharedMemory, owner: bool = False):
+        self._memory = memory
+        self._owner = owner
+        words = np.ndarray((_HEADER_WORDS,), dtype=np.uint64, buffer=memory.buf)
+        if bytes(memory.buf[:8]) != _MAGIC:
+            raise ValueError(f'Shared memory block {memory.name} does not hold a temporal collection')
+        self.format = _FORMATS[int(words[1])]
+        count = int(words[2])
+        self._offsets = np.ndarray((count + 1,), dtype=np.uint64, buffer=memory.buf, offset=8 * _HEADER_WORDS)
+
+    @staticmethod
+    def create(temporals: Sequence[Temporal], name: Optional[str] = None,
+               format: str = 'raw') -> SharedTemporalCollection:
+        """
+        Serializes the temporal values into a new shared memory block.
+        """
+        if format not in _FORMATS:
+            raise ValueError(f'Unknown format {format}, expected one of {_FORMATS}')
+        for temporal in temporals:
+            if not isinstance(temporal, Temporal):
+                raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        records = [_serialize(temporal, format) for temporal in temporals]
+        data_start = _align(8 * (_HEADER_WORDS + len(records) + 1))
+        offsets = np.empty(len(records) + 1, dtype=np.uint64)
+        position = data_start
+        for i, record in enumerate(records):
+            offsets[i] = position
+            position = _align(position + len(record))
+        offsets[-1] = position
+        # Imported here because shared_memory needs Python 3.8, while the rest of the package supports 3.7
+        from multiprocessing import shared_memory
+        memory = shared_memory.SharedMemory(name=name, create=True, size=max(position, 1))
+        try:
+            memory.buf[:8] = _MAGIC
+            words = np.ndarray((_HEADER_WORDS,), dtype=np.uint64, buffer=memory.buf)
+            words[1] = _FORMATS.index(format)
+            words[2] = len(records)
+            memory.buf[8 * _HEADER_WORDS:8 * (_HEADER_WORDS + len(offsets))] = offsets.tobytes()
+            for offset, record in zip(offsets, records):
+                memory.buf[int(offset):int(offset) + len(record)] = record
+            del words
+        except BaseException:
+            memory.close()
+            memory.unlink()
+            raise
+        return SharedTemporalCollection(memory, owner=True)
+
+    @staticmethod
+    def attach(name: str) -> SharedTemporalCollection:
+        """
+        Attaches to the collection stored in the shared memory block ``name``.
+        """
+        return SharedTemporalCollection(_attach_memory(name))
+
+    @property
+    def name(self) -> str:
+        return self._memory.name
+
+    @property
+    def size(self) -> int:
+        """
+        Size of the shared memory block in bytes.
+        """
+        return self._memory.size
+
+    def __len__(self):
+        return len(self._offsets) - 1
+
+    def __getitem__(self, item: Union[int, slice]) -> Union[Temporal, List[Temporal]]:
+        if isinstance(item, slice):
+            return [self[i] for i in range(*item.indices(len(self)))]
+        if item < 0:
+            item += len(self)
+        if not 0 <= item < len(self):
+            raise IndexError(f'Index {item} out of range')
+        return Temporal._factory(_deserialize(self.record(item), self.format))
+
+    def __iter__(self) -> Iterator[Temporal]:
+        return (self[i] for i in range(len(self)))
+
+    def record(self, n: int) -> memoryview:
+        """
+        Bytes of the ``n``-th record in the shared memory, without copying them.
+        """
+        start, end = int(self._offsets[n]), int(self._offsets[n + 1])
+        if self.format == 'raw':
+            end = start + _varsize(self._memory.buf[start:start + 4])
+        else:
+            end = start + 8 + int.from_bytes(self._memory.buf[start:start + 8], 'little')
+            start += 8
+        return self._memory.buf[start:end]
+
+    def map(self, function: Callable[[Temporal], R], indexes: Optional[Sequence[int]] = None,
+            max_workers: Optional[int] = None, chunksize: int = 64) -> List[R]:
+        """
+        Applies ``function`` to the values (or the ones in ``indexes``) on a process pool whose workers attach to
+        the collection once. ``function`` must be picklable, e.g., a module-level function.
+        """
+        indexes = list(range(len(self)) if indexes is None else indexes)
+        chunks = [indexes[i:i + chunksize] for i in range(0, len(indexes), chunksize)]
+        with ProcessPoolExecutor(max_workers=max_workers, initializer=_initialize_worker,
+                                 initargs=(self.name,)) as executor:
+            results = executor.map(_run_chunk, [function] * len(chunks), chunks)
+            return [r for chunk in results for r in chunk]
+
+    def close(self) -> None:
+        """
+        Detaches from the shared memory. Values read in raw format become invalid.
+        """
+        self._offsets = None
+        self._memory.close()
+
+    def unlink(self) -> None:
+        """
+        Releases the shared memory block once all the processes have closed it.
+        """
+        self._memory.unlink()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+        if self._owner:
+            self.unlink()
+
+    def __reduce__(self):
+        return SharedTemporalCollection.attach, (self.name,)
+
+
+def _align(position: int) -> int:
+    return (position + _ALIGNMENT - 1) // _ALIGNMENT * _ALIGNMENT
+
+
+def _ffi():
+    from pymeos_cffi.functions import _ffi
+    return _ffi
+
+
+def _varsize(header) -> int:
+    # 4-byte varlena header (little-endian): the size is stored shifted by two bits
+    return (int.from_bytes(header, 'little') >> 2) & 0x3FFFFFFF
+
+
+def _to_wkb(temporal: Temporal) -> bytes:
+    wkb, size = temporal_as_wkb(temporal._inner, _WKB_EXTENDED)
+    return _ffi().buffer(wkb, size)[:]
+
+
+def _from_wkb(data: bytes) -> Temporal:
+    return Temporal._factory(temporal_from_wkb(_ffi().from_buffer(data), len(data)))
+
+
+def _serialize(temporal: Temporal, format: str) -> bytes:
+    ffi = _ffi()
+    if format == 'raw':
+        size = _varsize(ffi.buffer(temporal._inner, 4))
+        return ffi.buffer(temporal._inner, size)[:]
+    # WKB records are prefixed by their size
+    wkb = _to_wkb(temporal)
+    return len(wkb).to_bytes(8, 'little') + wkb
+
+
+def _deserialize(record: memoryview, format: str):
+    ffi = _ffi()
+    pointer = ffi.from_buffer(record)
+    if format == 'raw':
+        return ffi.cast('Temporal *', pointer)
+    return temporal_from_wkb(pointer, len(record))
+
+
+def _attach_memory(name: str) -> shared_memory.SharedMemory:
+    # Attaching must not register the block for cleanup, it is owned by its creator. Before Python 3.13 this is
+    # only guaranteed for the processes sharing the resource tracker of the creator, such as its pool workers.
+    from multiprocessing import shared_memory
+    if sys.version_info >= (3, 13):
+        return shared_memory.SharedMemory(name=name, track=False)
+    return shared_memory.SharedMemory(name=name)
+
+
+_worker_collection: Optional[SharedTemporalCollection] = None
+
+
+def _initialize_worker(name: str) -> None:
+    global _worker_collection
+    from .meos_init import pymeos_initialize
+    pymeos_initialize()
+    _worker_collection = SharedTemporalCollection.attach(name)
+
+
+def _run_chunk(function: Callable[[Temporal], R], indexes: List[int]) -> List[R]:
+    return [function(_worker_collection[i]) for i in indexes]
@@ -0,0 +1,477 @@
+"""
+In-memory tables of moving objects: temporal columns and scalar attributes with indexes and a query API.
+
+    >>> table = MovingObjectTable(['trip'], ['vehicle', 'kind'])
+    >>> table.extend({'trip': trip, 'vehicle': v, 'kind': k} for trip, v, k in rows)
+    >>> table.query().during(period).ever_within(depot, 100).where('kind', '==', 'bus').select('vehicle')
+    >>> table.save('fleet.pymeos')
+
+Every temporal column has two indexes, built when first queried after a change:
+
+- an interval index over the bounding periods, made of the rows sorted by start and by end timestamp, so that a
+  time window is answered by two binary searches and a scan of the smaller side;
+- an STRtree over the spatial extents of the temporal points.
+
+Queries probe the indexes of all their index-assisted filters first and intersect the candidates, then evaluate
+the attribute predicates on numpy arrays, and only then the exact MEOS predicates on the remaining rows.
+"""
+from __future__ import annotations
+
+import operator
+import pickle
+from typing import Any, Callable, Dict, Iterable, List, Optional, Sequence, Tuple, Union
+
+import numpy as np
+import shapely
+from pymeos_cffi import dwithin_tpoint_geo, geometry_to_gserialized, gserialized_in, overlaps_temporal_period, \
+    overlaps_tpoint_stbox, period_lower, period_upper, stbox_to_period, stbox_xmax, stbox_xmin, stbox_ymax, \
+    stbox_ymin, temporal_end_timestamp, temporal_start_timestamp, tpoint_to_stbox
+
+from .aggregators.aggregator import BaseAggregator
+from .boxes import STBox
+from .main import TPoint
+from .parallel import parallel_map
+from .shared import _to_wkb, _from_wkb
+from .temporal import Temporal
+from .time import Period
+
+_MAGIC = b'PYMEOST\x01'
+_OPERATORS = {
+    '==': operator.eq, '!=': operator.ne, '<': operator.lt, '<=': operator.le, '>': operator.gt, '>=': operator.ge,
+    'in': lambda values, options: np.isin(values, list(options)),
+}
+
+
+class _ColumnIndex:
+    """
+    Interval index over the bounding periods and STRtree over the spatial extents of a temporal column.
+    """
+
+    def __init__(self, tmin: np.ndarray, tmax: np.ndarray, boxes: np.ndarray):
+        self.tmin, self.tmax = tmin, tmax
+        valid = np.flatnonzero(~np.isnan(tmin))
+        self.by_start = valid[np.argsort(tmin[valid], kind='stable')]
+        self.by_end = valid[np.argsort(tmax[valid], kind='stable')]
+        self.starts, self.ends = tmin[self.by_start], tmax[self.by_end]
+        self.spatial_rows = np.flatnonzero(~np.isnan(boxes[:, 0]))
+        rows = boxes[self.spatial_rows]
+        self.tree = shapely.STRtree(shapely.box(rows[:, 0], rows[:, 1], rows[:, 2], rows[:, 3]))
+
+    def during(self, lower: float, upper: float) -> np.ndarray:
+        # Rows whose bounding period intersects [lower, upper]
+        started = np.searchsorted(self.starts, upper, side='right')
+        not_ended = len(self.ends) - np.searchsorted(self.ends, lower, side='left')
+        if started <= not_ended:
+            rows = self.by_start[:started]
+            return np.sort(rows[self.tmax[rows] >= lower])
+        rows = self.by_end[len(self.ends) - not_ended:]
+        return np.sort(rows[self.tmin[rows] <= upper])
+
+    def spatial(self, geometry: shapely.Geometry, distance: Optional[float] = None) -> np.ndarray:
+        # Rows whose spatial extent intersects the geometry, or is within distance of it
+        if distance is None:
+            found = self.tree.query(geometry, predicate='intersects')
+        else:
+            found = self.tree.query(geometry, predicate='dwithin', distance=distance)
+        return np.sort(self.spatial_rows[found])
+
+
+class _Filter:
+    """
+    Filter of a query: an optional index probe returning candidate rows, and a check of a single row.
+    """
+
+    def __init__(self, description: str, check: Callable[[int], bool],
+                 probe: Optional[Callable[[], np.ndarray]] = None,
+                 vectorized: Optional[Callable[[np.ndarray], np.ndarray]] = None):
+        self.description = description
+        self.check = check
+        self.probe = probe
+        self.vectorized = vectorized
+
+
+class MovingObjectTable:
+    """
+    Table of rows made of temporal columns and attribute columns, identified by their position. See the module
+    documentation. Missing values are stored as ``None``.
+    """
+
+    def __init__(self, temporal_columns: Sequence[str], attribute_columns: Sequence[str] = ()):
+        if not temporal_columns:
+            raise ValueError('A table needs at least one temporal column')
+        if set(temporal_columns) & set(attribute_columns):
+            raise ValueError('Temporal and attribute columns must have different names')
+        self.temporal_columns = list(temporal_columns)
+        self.attribute_columns = list(attribute_columns)
+        self._temporals: Dict[str, List[Optional[Temporal]]] = {c: [] for c in self.temporal_columns}
+        self._attributes: Dict[str, List[Any]] = {c: [] for c in self.attribute_columns}
+        # Bounding period (MEOS timestamps) and spatial extent of every temporal value, NaN when missing
+        self._tmin: Dict[str, List[float]] = {c: [] for c in self.temporal_columns}
+        self._tmax: Dict[str, List[float]] = {c: [] for c in self.temporal_columns}
+        self._boxes: Dict[str, List[Tuple[float, float, float, float]]] = {c: [] for c in self.temporal_columns}
+        self._alive: List[bool] = []
+        self._indexes: Dict[str, _ColumnIndex] = {}
+        self._arrays: Dict[str, np.ndarray] = {}
+
+    @property
+    def columns(self) -> List[str]:
+        return self.temporal_columns + self.attribute_columns
+
+    def __len__(self):
+        return int(sum(self._alive))
+
+    def insert(self, **values) -> int:
+        """
+        Inserts a row and returns its id.
+        """
+        unknown = set(values) - set(self.columns)
+        if unknown:
+            raise ValueError(f'Unknown columns {sorted(unknown)}')
+        for column in self.temporal_columns:
+            temporal = values.get(column)
+            if temporal is not None and not isinstance(temporal, Temporal):
+                raise TypeError(f'Operation not supported with type {temporal.__class__}')
+            self._temporals[column].append(temporal)
+            self._append_bounds(column, temporal)
+        for column in self.attribute_columns:
+            self._attributes[column].append(values.get(column))
+        self._alive.append(True)
+        self._changed()
+        return len(self._alive) - 1
+
+    def extend(self, rows: Iterable[Dict[str, Any]]) -> List[int]:
+        """
+        Inserts the rows and returns their ids.
+        """
+        return [self.insert(**row) for row in rows]
+
+    def update(self, row_id: int, **values) -> None:
+        """
+        Replaces the given columns of a row.
+        """
+        self._check_row(row_id)
+        unknown = set(values) - set(self.columns)
+        if unknown:
+            raise ValueError(f'Unknown columns {sorted(unknown)}')
+        for column, value in values.items():
+            if column in self._temporals:
+                if value is not None and not isinstance(value, Temporal):
+                    raise TypeError(f'Operation not supported with type {value.__class__}')
+                self._temporals[column][row_id] = value
+                self._set_bounds(column, row_id, value)
+            else:
+                self._attributes[column][row_id] = value
+        self._changed()
+
+    def delete(self, row_ids: Union[int, Iterable[int]]) -> None:
+        """
+        Deletes rows. Their ids are not reused.
+        """
+        for row_id in [row_ids] if isinstance(row_ids, int) else row_ids:
+            self._check_row(row_id)
+            self._alive[row_id] = False
+            for column in self.temporal_columns:
+                self._temporals[column][row_id] = None
+                self._set_bounds(column, row_id, None)
+            for column in self.attribute_columns:
+                self._attributes[column][row_id] = None
+        self._changed()
+
+    def row(self, row_id: int) -> Dict[str, Any]:
+        """
+        Values of a row by column.
+        """
+        self._check_row(row_id)
+        return {column: self._value(column, row_id) for column in self.columns}
+
+    def query(self) -> TableQuery:
+        """
+        New query over the rows of the table.
+        """
+        return TableQuery(self)
+
+    def save(self, path: str) -> None:
+        """
+        Writes a binary snapshot of the table, with the temporal values as extended WKB and the bounds of the
+        indexes, so that loading it does not recompute them.
+        """
+        snapshot = {
+            'temporal_columns': self.temporal_columns,
+            'attribute_columns': self.attribute_columns,
+            'alive': np.array(self._alive, dtype=bool),
+            'attributes': self._attributes,
+            'temporals': {c: [None if t is None else _to_wkb(t) for t in values]
+                          for c, values in self._temporals.items()},
+            'tmin': {c: np.array(v, dtype=float) for c, v in self._tmin.items()},
+            'tmax': {c: np.array(v, dtype=float) for c, v in self._tmax.items()},
+            'boxes': {c: np.array(v, dtype=float).reshape(-1, 4) for c, v in self._boxes.items()},
+        }
+        with open(path, 'wb') as file:
+            file.write(_MAGIC)
+            pickle.dump(snapshot, file, protocol=pickle.HIGHEST_PROTOCOL)
+
+    @staticmethod
+    def load(path: str) -> MovingObjectTable:
+        """
+        Reads a table written by :meth:`save`. Snapshots are pickles, so only load trusted files.
+        """
+        with open(path, 'rb') as file:
+            if file.read(len(_MAGIC)) != _MAGIC:
+                raise ValueError(f'{path} is not a moving object table snapshot')
+            snapshot = pickle.load(file)
+        table = MovingObjectTable(snapshot['temporal_columns'], snapshot['attribute_columns'])
+        table._alive = snapshot['alive'].tolist()
+        table._attributes = snapshot['attributes']
+        table._temporals = {c: [None if w is None else _from_wkb(w) for w in values]
+                            for c, values in snapshot['temporals'].items()}
+        table._tmin = {c: v.tolist() for c, v in snapshot['tmin'].items()}
+        table._tmax = {c: v.tolist() for c, v in snapshot['tmax'].items()}
+        table._boxes = {c: [tuple(b) for b in v.tolist()] for c, v in snapshot['boxes'].items()}
+        return table
+
+    def _value(self, column: str, row_id: int) -> Any:
+        values = self._temporals.get(column)
+        return values[row_id] if values is not None else self._attributes[column][row_id]
+
+    def _check_row(self, row_id: int) -> None:
+        if not 0 <= row_id < len(self._alive) or not self._alive[row_id]:
+            raise KeyError(row_id)
+
+    def _append_bounds(self, column: str, temporal: Optional[Temporal]) -> None:
+        self._tmin[column].append(np.nan)
+        self._tmax[column].append(np.nan)
+        self._boxes[column].append((np.nan,) * 4)
+        self._set_bounds(column, len(self._tmin[column]) - 1, temporal)
+
+    def _set_bounds(self, column: str, row_id: int, temporal: Optional[Temporal]) -> None:
+        box = (np.nan,) * 4
+        if temporal is None:
+            tmin = tmax = np.nan
+        else:
+            tmin, tmax = temporal_start_timestamp(temporal._inner), temporal_end_timestamp(temporal._inner)
+            if isinstance(temporal, TPoint):
+                stbox = tpoint_to_stbox(temporal._inner)
+                box = (stbox_xmin(stbox), stbox_ymin(stbox), stbox_xmax(stbox), stbox_ymax(stbox))
+        self._tmin[column][row_id] = tmin
+        self._tmax[column][row_id] = tmax
+        self._boxes[column][row_id] = box
+
+    def _changed(self) -> None:
+        self._indexes.clear()
+        self._arrays.clear()
+
+    def _index(self, column: str) -> _ColumnIndex:
+        if column not in self._indexes:
+            self._indexes[column] = _ColumnIndex(np.array(self._tmin[column], dtype=float),
+                                                 np.array(self._tmax[column], dtype=float),
+                                                 np.array(self._boxes[column], dtype=float).reshape(-1, 4))
+        return self._indexes[column]
+
+    def _array(self, column: str) -> np.ndarray:
+        if column not in self._arrays:
+            values = self._attributes[column]
+            if all(v is None or isinstance(v, (int, float, np.number)) and not isinstance(v, bool) for v in values):
+                # Numeric attributes are compared as floats, with missing values as NaN
+                array = np.array([np.nan if v is None else v for v in values], dtype=float)
+            else:
+                array = np.empty(len(values), dtype=object)
+                array[:] = values
+            self._arrays[column] = array
+        return self._arrays[column]
+
+
+class TableQuery:
+    """
+    Filters, projections and aggregations over a :class:`MovingObjectTable`. Filters are added with chained calls
+    and combined with AND. The temporal filters apply to the first temporal column unless ``column`` is given.
+    """
+
+    def __init__(self, table: MovingObjectTable, filters: Tuple[_Filter, ...] = ()):
+        self._table = table
+        self._filters = filters
+
+    def _with(self, item: _Filter) -> TableQuery:
+        return TableQuery(self._table, self._filters + (item,))
+
+    def _column(self, column: Optional[str]) -> str:
+        column = self._table.temporal_columns[0] if column is None else column
+        if column not in self._table.temporal_columns:
+            raise ValueError(f'{column} is not a temporal column')
+        return column
+
+    def _temporal(self, column: str, row_id: int, point: bool = False) -> Optional[Temporal]:
+        temporal = self._table._temporals[column][row_id]
+        if point and temporal is not None and not isinstance(temporal, TPoint):
+            raise TypeError(f'Operation not supported with type {temporal.__class__}')
+        return temporal
+
+    def during(self, period: Period, column: Optional[str] = None) -> TableQuery:
+        """
+        Rows whose temporal value overlaps ``period`` in time.
+        """
+        column = self._column(column)
+        lower, upper = period_lower(period._inner), period_upper(period._inner)
+
+        def check(row_id: int) -> bool:
+            temporal = self._temporal(column, row_id)
+            return temporal is not None and overlaps_temporal_period(temporal._inner, period._inner)
+
+        return self._with(_Filter(f'{column} overlaps {period}', check,
+                                  lambda: self._table._index(column).during(lower, upper)))
+
+    def intersects_box(self, box: STBox, column: Optional[str] = None) -> TableQuery:
+        """
+        Rows whose temporal point has a bounding box overlapping ``box``.
+        """
+        column = self._column(column)
+
+        def probe() -> np.ndarray:
+            index = self._table._index(column)
+            rows = None
+            if box.has_xy:
+                rows = index.spatial(shapely.box(box.xmin, box.ymin, box.xmax, box.ymax))
+            if box.has_t:
+                period = stbox_to_period(box._inner)
+                during = index.during(period_lower(period), period_upper(period))
+                rows = during if rows is None else np.intersect1d(rows, during, assume_unique=True)
+            return rows
+
+        def check(row_id: int) -> bool:
+            temporal = self._temporal(column, row_id, point=True)
+            return temporal is not None and overlaps_tpoint_stbox(temporal._inner, box._inner)
+
+        return self._with(_Filter(f'{column} && {box}', check, probe))
+
+    def ever_within(self, geometry, distance: float, column: Optional[str] = None) -> TableQuery:
+        """
+        Rows whose temporal point is ever within ``distance`` of ``geometry`` (shapely or postgis). Shapely
+        geometries have no SRID, so they take the one of the temporal points of the column.
+        """
+        from .processing.nearest import _to_shapely
+        column = self._column(column)
+        shape = _to_shapely(geometry)
+        if shape is geometry:
+            srid = next((t.srid for t in self._table._temporals[column] if isinstance(t, TPoint)), 0)
+            gs = gserialized_in(shapely.to_wkb(shapely.set_srid(shape, srid), hex=True, include_srid=True), -1)
+        else:
+            gs = geometry_to_gserialized(geometry)
+
+        def check(row_id: int) -> bool:
+            temporal = self._temporal(column, row_id, point=True)
+            return temporal is not None and dwithin_tpoint_geo(temporal._inner, gs, distance) == 1
+
+        return self._with(_Filter(f'{column} ever within {distance} of {shape.geom_type}', check,
+                                  lambda: self._table._index(column).spatial(shape, distance)))
+
+    def where(self, attribute: str, op: Union[str, Callable[[Any], bool]], value: Any = None) -> TableQuery:
+        """
+        Rows whose ``attribute`` satisfies ``op``: a comparison (``==``, ``!=``, ``<``, ``<=``, ``>``, ``>=``, or
+        ``in`` with a collection) with ``value``, evaluated on a numpy array of the attribute, or a predicate
+        called with the value of the attribute.
+        """
+        if attribute not in self._table.attribute_columns:
+            raise ValueError(f'{attribute} is not an attribute column')
+        if callable(op):
+            return self._with(_Filter(f'{getattr(op, "__name__", "predicate")}({attribute})',
+                                      lambda row_id: bool(op(self._table._attributes[attribute][row_id]))))
+        if op not in _OPERATORS:
+            raise ValueError(f'Unknown operator {op}, expected one of {list(_OPERATORS)}')
+        function = _OPERATORS[op]
+
+        def vectorized(rows: np.ndarray) -> np.ndarray:
+            values = self._table._array(attribute)[rows]
+            with np.errstate(invalid='ignore'):
+                return np.asarray(function(values, value), dtype=bool)
+
+        return self._with(_Filter(f'{attribute} {op} {value!r}',
+                                  lambda row_id: bool(vectorized(np.array([row_id]))[0]), vectorized=vectorized))
+
+    def filter(self, predicate: Callable[[Dict[str, Any]], bool]) -> TableQuery:
+        """
+        Rows for which ``predicate`` holds, called with the row as a dictionary. Evaluated last.
+        """
+        return self._with(_Filter(f'{getattr(predicate, "__name__", "predicate")}(row)',
+                                  lambda row_id: bool(predicate(self._table.row(row_id)))))
+
+    def row_ids(self, max_workers: Optional[int] = None) -> np.ndarray:
+        """
+        Ids of the rows satisfying all the filters, in increasing order. Exact temporal predicates run on a thread
+        pool.
+        """
+        rows, _ = self._execute(max_workers)
+        return rows
+
+    def count(self, max_workers: Optional[int] = None) -> int:
+        return len(self.row_ids(max_workers))
+
+    def select(self, *columns: str, max_workers: Optional[int] = None) -> List[Dict[str, Any]]:
+        """
+        Rows satisfying the filters as dictionaries with the given columns (all by default) and their ``id``.
+        """
+        columns = columns or tuple(self._table.columns)
+        unknown = set(columns) - set(self._table.columns)
+        if unknown:
+            raise ValueError(f'Unknown columns {sorted(unknown)}')
+        return [{'id': int(r), **{c: self._table._value(c, int(r)) for c in columns}}
+                for r in self.row_ids(max_workers)]
+
+    def to_dataframe(self, *columns: str, max_workers: Optional[int] = None):
+        """
+        Result of :meth:`select` as a ``pandas.DataFrame`` indexed by row id.
+        """
+        from pandas import DataFrame
+        return DataFrame(self.select(*columns, max_workers=max_workers)).set_index('id')
+
+    def aggregate(self, aggregator: type, column: Optional[str] = None, by: Optional[str] = None,
+                  max_workers: Optional[int] = None) -> Union[Any, Dict[Any, Any]]:
+        """
+        Aggregates the temporal values of ``column`` of the rows satisfying the filters with ``aggregator``, a
+        PyMEOS aggregator class such as ``TemporalPointExtentAggregator``. With ``by``, the rows are grouped by the
+        value of that attribute and a dictionary is returned.
+        """
+        if not (isinstance(aggregator, type) and issubclass(aggregator, BaseAggregator)):
+            raise TypeError(f'Operation not supported with type {aggregator.__class__}')
+        column = self._column(column)
+        temporals = self._table._temporals[column]
+        rows = [int(r) for r in self.row_ids(max_workers) if temporals[r] is not None]
+        if by is None:
+            return aggregator.aggregate([temporals[r] for r in rows])
+        groups: Dict[Any, List[Temporal]] = {}
+        for r in rows:
+            groups.setdefault(self._table._attributes[by][r], []).append(temporals[r])
+        return {key: aggregator.aggregate(values) for key, values in groups.items()}
+
+    def explain(self) -> str:
+        """
+        Textual description of the execution plan, with the number of rows left after every step.
+        """
+        _, lines = self._execute(None)
+        return '\n'.join([f'Plan over {len(self._table)} rows:'] + lines)
+
+    def _execute(self, max_workers: Optional[int]) -> Tuple[np.ndarray, List[str]]:
+        table = self._table
+        lines = []
+        indexed = [f for f in self._filters if f.probe is not None]
+        probes = sorted(((f, f.probe()) for f in indexed), key=lambda item: len(item[1]))
+        rows = np.flatnonzero(np.array(table._alive, dtype=bool))
+        for f, candidates in probes:
+            rows = np.intersect1d(rows, candidates, assume_unique=True)
+            lines.append(f'  index probe: {f.description} -> {len(rows)} rows')
+        for f in self._filters:
+            if f.vectorized is not None:
+                rows = rows[f.vectorized(rows)]
+                lines.append(f'  attribute filter: {f.description} -> {len(rows)} rows')
+        for f, _ in probes:
+            keep = parallel_map(f.check, rows.tolist(), max_workers)
+            rows = rows[np.array(keep, dtype=bool)] if len(rows) > 0 else rows
+            lines.append(f'  exact check: {f.description} -> {len(rows)} rows')
+        for f in self._filters:
+            if f.probe is None and f.vectorized is None:
+                rows = rows[np.array([f.check(int(r)) for r in rows], dtype=bool)] if len(rows) > 0 else rows
+                lines.append(f'  row filter: {f.description} -> {len(rows)} rows')
+        return rows, lines
+
+    def __repr__(self):
+        return f'{self.__class__.__name__}({len(self._filters)} filters)'
+
+
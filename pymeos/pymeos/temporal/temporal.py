@@ -32,11 +32,13 @@ from pandas import DataFrame
 from pymeos_cffi import *
 
 from .interpolation import TInterpolation
+from ..cache import cached_operation
 from ..time import *
 
 if TYPE_CHECKING:
     from .tinstant import TInstant
     from ..main import TBool
+    from ..lazy import LazyTemporal
 TBase = TypeVar('TBase')
 TG = TypeVar('TG', bound='Temporal[Any]')
 TI = TypeVar('TI', bound='TInstant[Any]')
@@ -524,12 +526,14 @@ class Temporal(Generic[TBase, TG, TI, TS, TSS], ABC):
         else:
             raise TypeError(f'Operation not supported with type {other.__class__}')
 
+    @cached_operation('frechet_distance')
     def frechet_distance(self, other: Temporal) -> float:
         """
         Compute the Frechet distance between two temporal values.
         """
         return temporal_frechet_distance(self._inner, other._inner)
 
+    @cached_operation('dyntimewarp_distance')
     def dyntimewarp_distance(self, other: Temporal) -> float:
         """
         Computes the Dynamic Time Warp distance between two temporal values.
@@ -564,6 +568,14 @@ class Temporal(Generic[TBase, TG, TI, TS, TSS], ABC):
         from ..factory import _TemporalFactory
         return [_TemporalFactory.create_temporal(tiles[i]) for i in range(new_count)]
 
+    def lazy(self) -> LazyTemporal:
+        """
+        Returns a lazy expression over this value whose restrictions are fused and checked against the
+        bounding box before running. See :class:`LazyTemporal`.
+        """
+        from ..lazy import LazyTemporal
+        return LazyTemporal(self)
+
     def __comparable(self, other: Temporal) -> bool:
         if not isinstance(other, Temporal):
             return False
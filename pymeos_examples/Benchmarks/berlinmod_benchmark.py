@@ -0,0 +1,249 @@
+"""
+BerlinMOD-style query benchmark for PyMEOS.
+
+Generates a synthetic BerlinMOD-like dataset (vehicles driving between home and work on a street grid over the
+Brussels extent, EPSG:3857) whose size grows with the scale factor, runs the range, temporal, spatiotemporal,
+nearest-neighbour and aggregate query families of the BerlinMOD/R benchmark using PyMEOS, and reports the latency
+and memory of every query.
+
+    python berlinmod_benchmark.py --scale-factor 0.05 --repetitions 5 --csv results.csv
+
+As in BerlinMOD, the number of vehicles and of simulated days grow with the square root of the scale factor.
+"""
+import argparse
+import csv
+import resource
+import sys
+import time
+import tracemalloc
+from dataclasses import dataclass
+from datetime import datetime, timedelta, timezone
+from typing import Callable, List, Optional
+
+import numpy as np
+import postgis as pg
+import shapely.geometry as shp
+from pymeos import *
+
+SRID = 3857
+# Brussels extent in EPSG:3857
+XMIN, XMAX = 470000.0, 500000.0
+YMIN, YMAX = 6580000.0, 6610000.0
+GRID_STEP = 250.0
+START_DAY = datetime(2020, 6, 1, tzinfo=timezone.utc)
+
+
+@dataclass
+class Dataset:
+    trips: List[TGeomPointSeq]
+    vehicles: np.ndarray
+    homes: np.ndarray
+
+
+@dataclass
+class QueryResult:
+    family: str
+    name: str
+    result: str
+    mean_ms: float
+    min_ms: float
+    max_ms: float
+    python_peak_kib: float
+    rss_growth_kib: float
+
+
+def snap(point: np.ndarray) -> np.ndarray:
+    return np.round(point / GRID_STEP) * GRID_STEP
+
+
+def random_location(rng: np.random.Generator) -> np.ndarray:
+    return snap(np.array([rng.uniform(XMIN, XMAX), rng.uniform(YMIN, YMAX)]))
+
+
+def drive(rng: np.random.Generator, origin: np.ndarray, destination: np.ndarray, start: datetime,
+          sampling: float) -> TGeomPointSeq:
+    """
+    Trip following the street grid (first along X, then along Y) at a speed varying per block, sampled every
+    ``sampling`` seconds with GPS noise.
+    """
+    corner = np.array([destination[0], origin[1]])
+    waypoints = [origin]
+    for a, b in ((origin, corner), (corner, destination)):
+        blocks = max(1, int(np.abs(b - a).sum() // GRID_STEP))
+        waypoints.extend(a + (b - a) * (i / blocks) for i in range(1, blocks + 1))
+    waypoints = np.array(waypoints)
+    lengths = np.linalg.norm(np.diff(waypoints, axis=0), axis=1)
+    speeds = rng.uniform(5.0, 16.0, len(lengths))
+    arrival = np.concatenate([[0.0], np.cumsum(np.divide(lengths, speeds))])
+    seconds = np.arange(0.0, arrival[-1] + sampling, sampling) if arrival[-1] > 0 else np.array([0.0, sampling])
+    x = np.interp(seconds, arrival, waypoints[:, 0]) + rng.normal(0, 2.0, len(seconds))
+    y = np.interp(seconds, arrival, waypoints[:, 1]) + rng.normal(0, 2.0, len(seconds))
+    t = np.datetime64(start.replace(tzinfo=None), 'us') + (seconds * 1e6).astype('timedelta64[us]')
+    return TGeomPointSeq.from_arrays(t, x, y, srid=SRID, upper_inc=True)
+
+
+def generate(scale_factor: float, seed: int, sampling: float) -> Dataset:
+    rng = np.random.default_rng(seed)
+    num_vehicles = max(2, round(2000 * np.sqrt(scale_factor)))
+    num_days = max(1, round(28 * np.sqrt(scale_factor)))
+    homes = np.array([random_location(rng) for _ in range(num_vehicles)])
+    works = np.array([random_location(rng) for _ in range(num_vehicles)])
+    trips, vehicles = [], []
+    for day in range(num_days):
+        date = START_DAY + timedelta(days=day)
+        if date.weekday() >= 5:
+            continue
+        for v in range(num_vehicles):
+            departure = date + timedelta(hours=7, seconds=float(rng.uniform(0, 7200)))
+            trips.append(drive(rng, homes[v], works[v], departure, sampling))
+            vehicles.append(v)
+            departure = date + timedelta(hours=16, seconds=float(rng.uniform(0, 7200)))
+            trips.append(drive(rng, works[v], homes[v], departure, sampling))
+            vehicles.append(v)
+    return Dataset(trips, np.array(vehicles), homes)
+
+
+def random_period(rng: np.random.Generator, hours: float) -> Period:
+    # Within the morning peak of the first day
+    start = START_DAY + timedelta(hours=7, seconds=float(rng.uniform(0, 2 * 3600)))
+    return Period(lower=start, upper=start + timedelta(hours=hours))
+
+
+def random_box(rng: np.random.Generator, size: float, period: Optional[Period] = None) -> STBox:
+    x, y = rng.uniform(XMIN, XMAX - size), rng.uniform(YMIN, YMAX - size)
+    if period is None:
+        return STBox(xmin=x, xmax=x + size, ymin=y, ymax=y + size, srid=SRID)
+    return STBox(xmin=x, xmax=x + size, ymin=y, ymax=y + size, tmin=period.lower, tmax=period.upper, srid=SRID)
+
+
+def build_queries(dataset: Dataset, seed: int) -> List[tuple]:
+    rng = np.random.default_rng(seed + 1)
+    trips = dataset.trips
+    box = random_box(rng, 3000.0)
+    circle = shp.Point(rng.uniform(XMIN + 5000, XMAX - 5000), rng.uniform(YMIN + 5000, YMAX - 5000)).buffer(2500.0)
+    region = pg.Polygon([list(circle.exterior.coords)], srid=SRID)
+    period = random_period(rng, 1.0)
+    instant = period.lower + timedelta(minutes=30)
+    st_box = random_box(rng, 5000.0, period)
+    query_point = pg.Point(*random_location(rng), srid=SRID)
+    sample = trips[:min(len(trips), 50)]
+
+    def trips_in_box():
+        return sum(1 for t in trips if t.overlaps(box))
+
+    def trips_during_period():
+        return sum(1 for t in trips if t.at(period) is not None)
+
+    def positions_at_instant():
+        return sum(1 for t in trips if t.period.contains(instant) and t.value_at_timestamp(instant) is not None)
+
+    def vehicles_in_spacetime_box():
+        return len({int(v) for t, v in zip(trips, dataset.vehicles) if t.at(st_box) is not None})
+
+    def distance_inside_region():
+        total = 0.0
+        for t in trips:
+            clipped = t.at(region)
+            if clipped is not None:
+                total += clipped.length()
+        return round(total)
+
+    def nearest_vehicle_to_point():
+        distances = [t.nearest_approach_distance(query_point) for t in trips]
+        return int(dataset.vehicles[int(np.argmin(distances))])
+
+    def vehicle_pairs_within_distance():
+        pairs = 0
+        for i, a in enumerate(sample):
+            for b in sample[i + 1:]:
+                if a.period.overlaps(b.period):
+                    close = a.within_distance(b, 100.0)
+                    if close is not None and close.ever(True):
+                        pairs += 1
+        return pairs
+
+    def total_extent():
+        return TemporalPointExtentAggregator.aggregate(trips)
+
+    def active_vehicles_per_hour():
+        return TemporalPeriodCountAggregator.aggregate(trips, timedelta(hours=1)).max_value
+
+    def total_distance_and_duration():
+        return round(sum(t.length() for t in trips)), sum((t.duration for t in trips), timedelta())
+
+    return [
+        ('range', 'trips overlapping a box', trips_in_box),
+        ('temporal', 'trips restricted to a period', trips_during_period),
+        ('temporal', 'positions at an instant', positions_at_instant),
+        ('spatiotemporal', 'vehicles in a space-time box', vehicles_in_spacetime_box),
+        ('spatiotemporal', 'distance travelled inside a region', distance_inside_region),
+        ('nearest-neighbour', 'vehicle nearest to a point', nearest_vehicle_to_point),
+        ('nearest-neighbour', 'vehicle pairs within 100 m', vehicle_pairs_within_distance),
+        ('aggregate', 'spatiotemporal extent', total_extent),
+        ('aggregate', 'maximum active vehicles per hour', active_vehicles_per_hour),
+        ('aggregate', 'total distance and duration', total_distance_and_duration),
+    ]
+
+
+def peak_rss_kib() -> float:
+    # ru_maxrss is in KiB on Linux and in bytes on macOS
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return rss / 1024 if sys.platform == 'darwin' else rss
+
+
+def measure(family: str, name: str, query: Callable, repetitions: int) -> QueryResult:
+    times = []
+    result = None
+    rss_before = peak_rss_kib()
+    tracemalloc.start()
+    for _ in range(repetitions):
+        start = time.perf_counter()
+        result = query()
+        times.append((time.perf_counter() - start) * 1000)
+    _, python_peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    return QueryResult(family, name, str(result)[:40], float(np.mean(times)), min(times), max(times),
+                       python_peak / 1024, peak_rss_kib() - rss_before)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--scale-factor', type=float, default=0.005, help='BerlinMOD scale factor')
+    parser.add_argument('--repetitions', type=int, default=3, help='Executions of every query')
+    parser.add_argument('--sampling', type=float, default=10.0, help='Seconds between GPS observations')
+    parser.add_argument('--seed', type=int, default=1, help='Seed of the data and query generators')
+    parser.add_argument('--csv', help='Write the results to this CSV file')
+    args = parser.parse_args()
+
+    pymeos_initialize()
+    start = time.perf_counter()
+    dataset = generate(args.scale_factor, args.seed, args.sampling)
+    instants = sum(t.num_instants for t in dataset.trips)
+    print(f'Scale factor {args.scale_factor}: {len(dataset.homes)} vehicles, {len(dataset.trips)} trips, '
+          f'{instants} instants generated in {time.perf_counter() - start:.1f} s')
+
+    results = [measure(family, name, query, args.repetitions)
+               for family, name, query in build_queries(dataset, args.seed)]
+
+    header = f'{"family":<18} {"query":<36} {"mean ms":>10} {"min ms":>10} {"max ms":>10} ' \
+             f'{"py peak KiB":>12} {"rss +KiB":>10}  result'
+    print(header)
+    print('-' * len(header))
+    for r in results:
+        print(f'{r.family:<18} {r.name:<36} {r.mean_ms:>10.2f} {r.min_ms:>10.2f} {r.max_ms:>10.2f} '
+              f'{r.python_peak_kib:>12.1f} {r.rss_growth_kib:>10.0f}  {r.result}')
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['scale_factor', 'family', 'query', 'mean_ms', 'min_ms', 'max_ms', 'python_peak_kib',
+                             'rss_growth_kib', 'result'])
+            for r in results:
+                writer.writerow([args.scale_factor, r.family, r.name, f'{r.mean_ms:.3f}', f'{r.min_ms:.3f}',
+                                 f'{r.max_ms:.3f}', f'{r.python_peak_kib:.1f}', f'{r.rss_growth_kib:.0f}', r.result])
+
+    pymeos_finalize()
+
+
+if __name__ == '__main__':
+    main()